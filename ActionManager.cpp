@@ -12,6 +12,7 @@
 #include "Settings.h"
 #include "BaseToolkit.h"
 #include "Interpolator.h"
+#include "DecoderThreads.h"
 
 #include "ActionManager.h"
 
@@ -26,6 +27,9 @@ using namespace tinyxml2;
 
 void captureMixerSession(tinyxml2::XMLDocument *doc, std::string node, std::string label)
 {
+    // run on all cores (not on the core of the render thread if pinned)
+    DecoderThreads::unpinThread();
+
     // create node
     XMLElement *sessionNode = doc->NewElement( node.c_str() );
     doc->InsertEndChild(sessionNode);
@@ -0,0 +1,151 @@
+#include <thread>
+
+#if defined(LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "defines.h"
+#include "Log.h"
+#include "Settings.h"
+
+#include "DecoderThreads.h"
+
+std::atomic<guint> DecoderThreads::pipelines_(0);
+
+#if defined(LINUX)
+// cores of the process before the render thread was pinned
+static cpu_set_t all_cores_;
+static std::atomic<bool> pinned_(false);
+#endif
+
+guint DecoderThreads::budget()
+{
+    if ( Settings::application.render.decoder_threads > 0 )
+        return (guint) Settings::application.render.decoder_threads;
+
+    return MAX( std::thread::hardware_concurrency(), 2u ) - 1;
+}
+
+guint DecoderThreads::threads(int priority)
+{
+    guint b = budget();
+    guint share = MAX( b / MAX(pipelines_.load(), 1u), 1u );
+
+    if (priority < 1)
+        return MIN( share * 2, b );
+    else if (priority < 2)
+        return share;
+    return 1;
+}
+
+WorkerPool &DecoderThreads::pool()
+{
+    static WorkerPool pool_( budget() );
+    return pool_;
+}
+
+void DecoderThreads::element_added(GstBin *, GstBin *, GstElement *element, gpointer p)
+{
+    // only video decoders
+    GstElementFactory *factory = gst_element_get_factory(element);
+    if (factory == nullptr)
+        return;
+    const gchar *klass = gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+    if ( klass == nullptr || !g_strrstr(klass, "Decoder") || !g_strrstr(klass, "Video") )
+        return;
+
+    WorkerPool::Priority priority = *(WorkerPool::Priority *) p;
+    guint n = threads( priority ? priority->load() : 1 );
+
+    // threads property of libav, vpx and dav1d decoders
+    const char *names[3] = { "max-threads", "threads", "n-threads" };
+    for (int i = 0; i < 3; ++i) {
+        GParamSpec *spec = g_object_class_find_property(G_OBJECT_GET_CLASS(element), names[i]);
+        if (spec == nullptr)
+            continue;
+        if (spec->value_type == G_TYPE_INT)
+            g_object_set(G_OBJECT(element), names[i], (gint) n, NULL);
+        else if (spec->value_type == G_TYPE_UINT)
+            g_object_set(G_OBJECT(element), names[i], n, NULL);
+#ifndef NDEBUG
+        Log::Info("Decoder %s limited to %d threads", GST_ELEMENT_NAME(element), n);
+#endif
+        break;
+    }
+}
+
+void DecoderThreads::release(gpointer p, GClosure *)
+{
+    delete (WorkerPool::Priority *) p;
+    --pipelines_;
+}
+
+void DecoderThreads::setup(GstElement *pipeline, WorkerPool::Priority priority)
+{
+    if ( !GST_IS_BIN(pipeline) )
+        return;
+
+    // counted until the pipeline is destroyed (and releases the signal)
+    ++pipelines_;
+    g_signal_connect_data(G_OBJECT(pipeline), "deep-element-added", G_CALLBACK(element_added),
+                          new WorkerPool::Priority(priority), release, (GConnectFlags) 0);
+
+    // streaming threads of the pipeline run on all cores
+    unpinStreamingThreads(pipeline);
+}
+
+void DecoderThreads::stream_status(GstBus *, GstMessage *msg, gpointer)
+{
+    // posted by the streaming thread itself when it starts
+    GstStreamStatusType type;
+    GstElement *owner = nullptr;
+    gst_message_parse_stream_status(msg, &type, &owner);
+    if (type == GST_STREAM_STATUS_TYPE_ENTER)
+        unpinThread();
+}
+
+void DecoderThreads::unpinStreamingThreads(GstElement *pipeline)
+{
+#if defined(LINUX)
+    if ( !pinned_ || !GST_IS_PIPELINE(pipeline) )
+        return;
+
+    GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline));
+    gst_bus_enable_sync_message_emission(bus);
+    g_signal_connect(G_OBJECT(bus), "sync-message::stream-status", G_CALLBACK(stream_status), NULL);
+    gst_object_unref(bus);
+#else
+    (void) pipeline;
+#endif
+}
+
+void DecoderThreads::unpinThread()
+{
+#if defined(LINUX)
+    if ( pinned_ )
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &all_cores_);
+#endif
+}
+
+bool DecoderThreads::pinRenderThread()
+{
+#if defined(LINUX)
+    // threads created by the render thread inherit its affinity: they
+    // are given back all the cores (see unpinThread)
+    if ( sched_getaffinity(0, sizeof(cpu_set_t), &all_cores_) == 0 ) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(0, &cpuset);
+        if ( pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0 ) {
+            pinned_ = true;
+            // worker threads of pools run on all cores
+            WorkerPool::setThreadInit( unpinThread );
+            Log::Info("Render thread running on first core.");
+            return true;
+        }
+    }
+#endif
+    Log::Info("Render thread cannot be kept on one core.");
+    return false;
+}
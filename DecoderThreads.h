@@ -0,0 +1,80 @@
+#ifndef DECODERTHREADS_H
+#define DECODERTHREADS_H
+
+#include <atomic>
+
+#include <gst/gst.h>
+
+#include "WorkerPool.h"
+
+/**
+ * @brief The DecoderThreads class
+ *
+ * Shares a global budget of decoding threads between all the media
+ * pipelines, instead of letting each video decoder start one thread
+ * per core (hundreds of threads for a session with many sources).
+ *
+ * The number of threads of a decoder is set when it is added to its
+ * pipeline, from the budget, the number of pipelines and the priority
+ * of the pipeline:
+ * - priority 0 (e.g. current source) takes twice the share of others,
+ * - priority 1 (e.g. visible source) takes an equal share of the budget,
+ * - lower priorities (e.g. background source) take a single thread.
+ * A change of priority applies when the pipeline is re-created.
+ *
+ * The share is a cap per pipeline, computed when its decoder is created:
+ * it is not recomputed when pipelines are added or removed, and the
+ * decoders of pipelines created at different times can together use
+ * more threads than the budget.
+ */
+class DecoderThreads
+{
+public:
+    /**
+     * Total number of decoding threads (Settings, default to
+     * number of cores minus one for the render thread)
+     * */
+    static guint budget();
+    /**
+     * Number of threads for a decoder with this priority
+     * (share of the budget for the current number of pipelines)
+     * */
+    static guint threads(int priority);
+    /**
+     * Limit the threads of decoders of this pipeline (before playing)
+     * (no priority means equal share)
+     * */
+    static void setup(GstElement *pipeline, WorkerPool::Priority priority = nullptr);
+    /**
+     * Pool shared by the decoding jobs of vimix (images of sequences,
+     * JPEG frames, chunks of reverse playback), sized to the budget
+     * */
+    static WorkerPool &pool();
+    /**
+     * Get number of pipelines sharing the budget
+     * */
+    static guint numPipelines() { return pipelines_; }
+    /**
+     * Keep the calling thread (render thread) on the first core
+     * returns false if not supported
+     * */
+    static bool pinRenderThread();
+    /**
+     * Let the calling thread run on all cores (e.g. a worker thread
+     * created by the pinned render thread, which inherits its affinity)
+     * */
+    static void unpinThread();
+    /**
+     * Let the streaming threads of this pipeline run on all cores
+     * (done by setup)
+     * */
+    static void unpinStreamingThreads(GstElement *pipeline);
+
+private:
+    static void element_added(GstBin *, GstBin *, GstElement *element, gpointer p);
+    static void release(gpointer p, GClosure *);
+    static void stream_status(GstBus *, GstMessage *msg, gpointer);
+    static std::atomic<guint> pipelines_;
+};
+
+#endif // DECODERTHREADS_H
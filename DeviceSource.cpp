@@ -15,6 +15,7 @@
 #include "Decorations.h"
 #include "Stream.h"
 #include "Visitor.h"
+#include "Settings.h"
 #include "Log.h"
 
 #ifndef NDEBUG
@@ -32,6 +33,20 @@ std::string gst_plugin_device = "v4l2src";
 std::string gst_plugin_vidcap = "ximagesrc";
 #endif
 
+int DeviceConfig::formatScore(const std::string &stream, const std::string &format)
+{
+    // with native YUV (Settings, applied at restart): best score for YUV uploaded
+    // as is (converted on GPU), then RGBx and JPEG (decoded in parallel)
+    if ( Settings::application.render.native_yuv ) {
+        if ( stream.find("jpeg") != std::string::npos )
+            return 2;
+        if ( format == "YUY2" || format == "NV12" || format == "I420" )
+            return 3;
+    }
+    // otherwise best score for RGBx (no conversion to RGBA needed)
+    return format.find("R") != std::string::npos ? 2 : 1;
+}
+
 ////EXAMPLE :
 ///
 //v4l2deviceprovider, udev-probed=(boolean)true,
@@ -219,6 +234,28 @@ Device::Device()
     }
     g_list_free(devices);
 
+#ifdef DEVICE_DEBUG
+    // emulated devices, to test capture of raw YUV and MJPEG
+    DeviceConfig testconf;
+    testconf.width = 1920;
+    testconf.height = 1080;
+    testconf.fps_numerator = 60;
+    testconf.stream = "video/x-raw";
+    testconf.format = "YUY2";
+    DeviceConfigSet testconfs;
+    testconfs.insert(testconf);
+    src_name_.push_back("Test YUY2");
+    src_description_.push_back("videotestsrc is-live=true");
+    src_config_.push_back(testconfs);
+    testconf.stream = "image/jpeg";
+    testconf.format = "";
+    testconfs.clear();
+    testconfs.insert(testconf);
+    src_name_.push_back("Test MJPEG");
+    src_description_.push_back("videotestsrc is-live=true ! jpegenc");
+    src_config_.push_back(testconfs);
+#endif
+
     // Add config for plugged screen
     src_name_.push_back("Screen capture");
     src_description_.push_back(gst_plugin_vidcap);
@@ -376,20 +413,35 @@ void DeviceSource::setDevice(const std::string &devicename)
         pipeline << ",width=" << best.width;
         pipeline << ",height=" << best.height;
 
+        // JPEG images are decoded by the stream (in parallel)
+        Stream::Format format = Stream::RGBA;
         if ( best.stream.find("jpeg") != std::string::npos )
-            pipeline << " ! jpegdec";
-
-        if ( device_.find("Screen") != std::string::npos )
-            pipeline << " ! videoconvert ! video/x-raw,format=RGB ! queue max-size-buffers=3";
+            format = Stream::JPEG;
+        else if ( device_.find("Screen") != std::string::npos ) {
+            pipeline << " ! videoconvert ! video/x-raw,format=RGB";
+            if ( !Settings::application.render.low_latency_capture )
+                pipeline << " ! queue max-size-buffers=3";
+        }
+        // native YUV frames are uploaded as is and converted on GPU
+        else if ( Settings::application.render.native_yuv ) {
+            if ( best.format == "YUY2" )
+                format = Stream::YUY2;
+            else if ( best.format == "NV12" )
+                format = Stream::NV12;
+            else if ( best.format == "I420" )
+                format = Stream::I420;
+        }
 
-        pipeline << " ! videoconvert";
+        if ( format == Stream::RGBA )
+            pipeline << " ! videoconvert";
 
         // resize render buffer
         if (renderbuffer_)
             renderbuffer_->resize(best.width, best.height);
 
-        // open gstreamer
-        stream_->open( pipeline.str(), best.width, best.height);
+        // open gstreamer (without buffering in low latency)
+        stream_->setLowLatency( Settings::application.render.low_latency_capture );
+        stream_->open( pipeline.str(), best.width, best.height, format);
         stream_->play(true);
 
         // will be ready after init and one frame rendered
@@ -478,14 +530,10 @@ DeviceConfigSet Device::getDeviceConfigs(const std::string &src_description)
                             for (int n = 0; n < N; n++ ){
                                 std::string f = gst_value_serialize( gst_value_list_get_value(val, n) );
 
-                                // preference order : 1) RGBx, 2) JPEG, 3) ALL OTHER
-                                // select f if it contains R (e.g. for RGBx) and not already RGB in config
-                                if ( (f.find("R") != std::string::npos) && (config.format.find("R") == std::string::npos ) ) {
-                                    config.format = f;
-                                    break;
-                                }
-                                // default, take at least one if nothing yet in config
-                                else if ( config.format.empty() )
+                                // preference order : 1) native YUV (if enabled), 2) RGBx, 3) ALL OTHER
+                                // (take at least one if nothing yet in config)
+                                if ( config.format.empty() || DeviceConfig::formatScore(config.stream, f) >
+                                     DeviceConfig::formatScore(config.stream, config.format) )
                                     config.format = f;
                             }
 
@@ -61,10 +61,13 @@ struct DeviceConfig {
         return *this;
     }
 
+    // cost of handling the format (higher is better, see DeviceSource.cpp)
+    static int formatScore(const std::string &stream, const std::string &format);
+
     inline bool operator < (const DeviceConfig b) const
     {
-        int formatscore = this->format.find("R") != std::string::npos ? 2 : 1; // best score for RGBx
-        int b_formatscore = b.format.find("R") != std::string::npos ? 2 : 1;
+        int formatscore = formatScore(this->stream, this->format);
+        int b_formatscore = formatScore(b.stream, b.format);
         float fps = static_cast<float>(this->fps_numerator) / static_cast<float>(this->fps_denominator);
         float b_fps = static_cast<float>(b.fps_numerator) / static_cast<float>(b.fps_denominator);
         return ( fps * static_cast<float>(this->height * formatscore) < b_fps * static_cast<float>(b.height * b_formatscore));
@@ -177,18 +177,7 @@ void FrameBuffer::resize(int width, int height)
         if (attrib_.viewport.x != width || attrib_.viewport.y != height)
         {
             // de-init
-            glDeleteFramebuffers(1, &framebufferid_);
-            framebufferid_ = 0;
-
-            if (intermediate_framebufferid_)
-                glDeleteFramebuffers(1, &intermediate_framebufferid_);
-            intermediate_framebufferid_ = 0;
-            if (textureid_)
-                glDeleteTextures(1, &textureid_);
-            textureid_ = 0;
-            if (intermediate_textureid_)
-                glDeleteTextures(1, &intermediate_textureid_);
-            intermediate_textureid_ = 0;
+            discard();
 
             // change resolution
             attrib_.viewport = glm::ivec2(width, height);
@@ -196,6 +185,23 @@ void FrameBuffer::resize(int width, int height)
     }
 }
 
+void FrameBuffer::discard()
+{
+    if (framebufferid_)
+        glDeleteFramebuffers(1, &framebufferid_);
+    framebufferid_ = 0;
+
+    if (intermediate_framebufferid_)
+        glDeleteFramebuffers(1, &intermediate_framebufferid_);
+    intermediate_framebufferid_ = 0;
+    if (textureid_)
+        glDeleteTextures(1, &textureid_);
+    textureid_ = 0;
+    if (intermediate_textureid_)
+        glDeleteTextures(1, &intermediate_textureid_);
+    intermediate_textureid_ = 0;
+}
+
 void FrameBuffer::begin(bool clear)
 {
     if (!framebufferid_)
@@ -70,6 +70,8 @@ public:
     inline uint height() const { return attrib_.viewport.y; }
     glm::vec3 resolution() const;
     void resize(int width, int height);
+    // free GPU memory (allocated again when drawn or filled)
+    void discard();
     float aspectRatio() const;
     std::string info() const;
 
@@ -0,0 +1,202 @@
+#include "defines.h"
+#include "Log.h"
+#include "BaseToolkit.h"
+#include "Settings.h"
+#include "GstToolkit.h"
+
+#include "FrameCache.h"
+
+#ifndef NDEBUG
+#define FRAMECACHE_DEBUG
+#endif
+
+std::list<FrameCache*> FrameCache::caches_;
+std::mutex FrameCache::registry_;
+std::atomic<guint64> FrameCache::memory_(0);
+std::atomic<guint64> FrameCache::hits_(0);
+std::atomic<guint64> FrameCache::misses_(0);
+
+guint64 FrameCache::budget()
+{
+    return static_cast<guint64>( MAX(Settings::application.render.frame_cache_budget, 0) ) * 1048576;
+}
+
+size_t FrameCache::numCaches()
+{
+    std::lock_guard<std::mutex> lock(registry_);
+    return caches_.size();
+}
+
+bool FrameCache::reserve(FrameCache *requester, gsize size)
+{
+    std::lock_guard<std::mutex> lock(registry_);
+
+    // free least recently used caches until the budget allows size
+    while ( memory_ + size > budget() ) {
+        FrameCache *lru = nullptr;
+        for (auto c = caches_.begin(); c != caches_.end(); ++c) {
+            if ( *c != requester && (*c)->memory() > 0 &&
+                 ( lru == nullptr || (*c)->last_access_ < lru->last_access_ ) )
+                lru = *c;
+        }
+        // nothing else to free
+        if (lru == nullptr)
+            return false;
+#ifdef FRAMECACHE_DEBUG
+        Log::Info("Frame cache evicted %s.", BaseToolkit::byte_to_string(lru->memory()).c_str());
+#endif
+        lru->clear();
+    }
+
+    // count the memory now (checked and added under the same lock)
+    memory_ += size;
+
+    return true;
+}
+
+FrameCache::FrameCache(gsize frame_size) : frame_size_(frame_size), complete_(false), overflow_(false), bytes_(0)
+{
+    last_access_ = g_get_monotonic_time();
+
+    std::lock_guard<std::mutex> lock(registry_);
+    caches_.push_back(this);
+}
+
+FrameCache::~FrameCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(registry_);
+        caches_.remove(this);
+    }
+    clear();
+}
+
+bool FrameCache::store(GstClockTime pts, GstVideoFrame *frame, const GstVideoInfo *info)
+{
+    if ( overflow_ )
+        return false;
+
+    if ( complete_ || !GST_CLOCK_TIME_IS_VALID(pts) )
+        return true;
+
+    last_access_ = g_get_monotonic_time();
+
+    // already in cache
+    access_.lock();
+    bool known = frames_.count(pts) > 0;
+    access_.unlock();
+    if (known)
+        return true;
+
+    // make room and count the memory of the frame
+    // (NB: not under lock as it can free other caches)
+    if ( !reserve(this, frame_size_) ) {
+        // cannot cache all frames: give up
+        clear();
+        overflow_ = true;
+#ifdef FRAMECACHE_DEBUG
+        Log::Info("Frame cache over budget.");
+#endif
+        return false;
+    }
+
+    FrameData data = std::make_shared< std::vector<guint8> >(frame_size_);
+    GstToolkit::copy_video_frame(data->data(), info, frame);
+
+    access_.lock();
+    frames_[pts] = data;
+    bytes_ += frame_size_;
+    access_.unlock();
+
+    return true;
+}
+
+bool FrameCache::validate(const Timeline &timeline)
+{
+    std::lock_guard<std::mutex> lock(access_);
+
+    bool covered = !frames_.empty() && timeline.step() != GST_CLOCK_TIME_NONE;
+    GstClockTime tolerance = 2 * timeline.step();
+
+    // every section must be filled with consecutive frames
+    TimeIntervalSet sections = timeline.sections();
+    for (auto s = sections.begin(); covered && s != sections.end(); ++s) {
+        GstClockTime t = (*s).begin;
+        auto f = frames_.lower_bound( t > tolerance ? t - tolerance : 0 );
+        for (; covered && f != frames_.end() && f->first < (*s).end; ++f) {
+            covered = f->first <= t + tolerance;
+            t = f->first;
+        }
+        covered = covered && t + tolerance >= (*s).end;
+    }
+
+    complete_ = covered;
+
+#ifdef FRAMECACHE_DEBUG
+    if (complete_)
+        Log::Info("Frame cache complete with %d frames (%s).", (int) frames_.size(),
+                  BaseToolkit::byte_to_string(bytes_).c_str());
+#endif
+
+    return complete_;
+}
+
+FrameCache::FrameData FrameCache::lookup(GstClockTime t, GstClockTime step, GstClockTime *pts)
+{
+    FrameData data;
+    last_access_ = g_get_monotonic_time();
+
+    access_.lock();
+    if ( !frames_.empty() && GST_CLOCK_TIME_IS_VALID(t) ) {
+        // closest frame before t (or first frame)
+        auto f = frames_.upper_bound(t);
+        if (f != frames_.begin())
+            --f;
+        // accept only if not too far from t (hole in cache)
+        if ( ABS_DIFF(f->first, t) < 2 * step ) {
+            data = f->second;
+            if (pts)
+                *pts = f->first;
+        }
+    }
+    access_.unlock();
+
+    if (data)
+        ++hits_;
+    else
+        ++misses_;
+
+    return data;
+}
+
+void FrameCache::miss()
+{
+    ++misses_;
+}
+
+void FrameCache::clear()
+{
+    access_.lock();
+    memory_ -= bytes_;
+    bytes_ = 0;
+    frames_.clear();
+    complete_ = false;
+    access_.unlock();
+}
+
+void FrameCache::reset()
+{
+    clear();
+    overflow_ = false;
+}
+
+guint64 FrameCache::memory() const
+{
+    return bytes_;
+}
+
+size_t FrameCache::numFrames()
+{
+    std::lock_guard<std::mutex> lock(access_);
+    return frames_.size();
+}
@@ -0,0 +1,105 @@
+#ifndef FRAMECACHE_H
+#define FRAMECACHE_H
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <list>
+#include <map>
+
+#include <gst/video/video.h>
+
+#include "Timeline.h"
+
+// maximum duration of media eligible to cache
+#define FRAMECACHE_MAX_DURATION (10 * GST_SECOND)
+
+/**
+ * @brief The FrameCache class
+ *
+ * Copy in RAM of the decoded frames of a (short) media, indexed by
+ * presentation time stamp. Once the cache covers all the sections of
+ * the timeline, it is complete and the media player can display any
+ * frame at any time (step, scrubbing, reverse play, loops) without
+ * decoding anything.
+ *
+ * All caches share a global memory budget (Settings); when it is
+ * exceeded, the least recently used caches are emptied to make room.
+ * Hits and misses of all caches are counted for the Metrics.
+ */
+class FrameCache
+{
+public:
+    typedef std::shared_ptr< std::vector<guint8> > FrameData;
+
+    /**
+     * Create a cache for frames of given size in bytes
+     * */
+    FrameCache(gsize frame_size);
+    ~FrameCache();
+    /**
+     * Copy the planes of the frame (with the layout of info)
+     * Can be called from any thread
+     * returns false if the budget cannot afford it (and
+     * the cache stays empty until reset)
+     * */
+    bool store(GstClockTime pts, GstVideoFrame *frame, const GstVideoInfo *info);
+    /**
+     * Test if cached frames cover all sections of the timeline
+     * (e.g. after end of stream) and set complete accordingly
+     * */
+    bool validate(const Timeline &timeline);
+    /**
+     * True if all frames of the timeline are in cache
+     * */
+    inline bool complete() const { return complete_; }
+    /**
+     * Get the frame to display at time t (i.e. closest frame before)
+     * returns empty FrameData on miss; pts is set on hit
+     * */
+    FrameData lookup(GstClockTime t, GstClockTime step, GstClockTime *pts);
+    /**
+     * Count a frame that had to be decoded
+     * */
+    void miss();
+    /**
+     * Free all frames
+     * */
+    void clear();
+    /**
+     * Free all frames and accept to store again after overflow
+     * */
+    void reset();
+    /**
+     * Memory used by this cache (in bytes)
+     * */
+    guint64 memory() const;
+    size_t numFrames();
+
+    // shared engine
+    static guint64 budget();
+    static guint64 memoryUsage() { return memory_; }
+    static guint64 numHits() { return hits_; }
+    static guint64 numMisses() { return misses_; }
+    static size_t numCaches();
+
+private:
+    std::map<GstClockTime, FrameData> frames_;
+    gsize frame_size_;
+    std::mutex access_;
+    std::atomic<bool> complete_;
+    std::atomic<bool> overflow_;
+    std::atomic<guint64> last_access_;
+    std::atomic<guint64> bytes_;
+
+    // global list of caches
+    static bool reserve(FrameCache *requester, gsize size);
+    static std::list<FrameCache*> caches_;
+    static std::mutex registry_;
+    static std::atomic<guint64> memory_;
+    static std::atomic<guint64> hits_;
+    static std::atomic<guint64> misses_;
+};
+
+#endif // FRAMECACHE_H
@@ -0,0 +1,131 @@
+#include "FrameQueue.h"
+
+// a slot holds its state and the sequence number of its frame in one
+// atomic value, so that compare-and-swap on a slot also checks its frame
+#define SLOT(seq, state) ( ((seq) << 2) | (uint64_t) (state) )
+#define SLOT_STATE(v) ( (int) ((v) & 3) )
+#define SLOT_SEQUENCE(v) ( (v) >> 2 )
+
+std::atomic<uint64_t> FrameQueue::total_dropped_(0);
+std::atomic<uint64_t> FrameQueue::total_overwritten_(0);
+
+FrameQueue::FrameQueue(unsigned int size) : size_(size), slot_(new std::atomic<uint64_t>[size]),
+    latest_(-1), write_index_(0), writing_(-1), counter_(0), reading_(-1), dropped_(0), overwritten_(0)
+{
+    for (unsigned int i = 0; i < size_; ++i)
+        slot_[i] = SLOT(0, EMPTY);
+}
+
+int FrameQueue::write()
+{
+    writing_ = -1;
+
+    for (int attempt = 0; attempt < 2 && writing_ < 0; ++attempt) {
+
+        // take the next free slot, in ring order
+        for (unsigned int k = 0; k < size_ && writing_ < 0; ++k) {
+            unsigned int i = (write_index_ + k) % size_;
+            uint64_t v = slot_[i].load();
+            if ( SLOT_STATE(v) == EMPTY &&
+                 slot_[i].compare_exchange_strong(v, SLOT(SLOT_SEQUENCE(v), WRITING)) )
+                writing_ = i;
+        }
+
+        // otherwise overwrite the oldest unread frame
+        if (writing_ < 0) {
+            int oldest = -1;
+            uint64_t oldest_value = 0;
+            for (unsigned int i = 0; i < size_; ++i) {
+                uint64_t v = slot_[i].load();
+                if ( SLOT_STATE(v) == READY && (oldest < 0 || SLOT_SEQUENCE(v) < SLOT_SEQUENCE(oldest_value)) ) {
+                    oldest = i;
+                    oldest_value = v;
+                }
+            }
+            // fails if the consumer took it meanwhile: try again
+            if ( oldest > -1 &&
+                 slot_[oldest].compare_exchange_strong(oldest_value, SLOT(SLOT_SEQUENCE(oldest_value), WRITING)) ) {
+                writing_ = oldest;
+                ++overwritten_;
+                ++total_overwritten_;
+            }
+        }
+    }
+
+    // no slot available: the frame is lost
+    if (writing_ < 0) {
+        ++dropped_;
+        ++total_dropped_;
+    }
+
+    return writing_;
+}
+
+void FrameQueue::publish()
+{
+    if (writing_ < 0)
+        return;
+
+    slot_[writing_] = SLOT(++counter_, READY);
+    latest_ = writing_;
+
+    write_index_ = (writing_ + 1) % size_;
+    writing_ = -1;
+}
+
+void FrameQueue::cancel()
+{
+    if (writing_ < 0)
+        return;
+
+    slot_[writing_] = SLOT(0, EMPTY);
+    writing_ = -1;
+}
+
+int FrameQueue::read()
+{
+    reading_ = -1;
+
+    int i = latest_;
+    if (i < 0)
+        return -1;
+
+    // take the latest frame, unless already read (or being overwritten)
+    uint64_t v = slot_[i].load();
+    if ( SLOT_STATE(v) != READY ||
+         !slot_[i].compare_exchange_strong(v, SLOT(SLOT_SEQUENCE(v), READING)) )
+        return -1;
+    reading_ = i;
+
+    // older frames will never be read: free their slots
+    uint64_t sequence = SLOT_SEQUENCE(v);
+    for (unsigned int j = 0; j < size_; ++j) {
+        uint64_t w = slot_[j].load();
+        if ( SLOT_STATE(w) == READY && SLOT_SEQUENCE(w) < sequence &&
+             slot_[j].compare_exchange_strong(w, SLOT(SLOT_SEQUENCE(w), EMPTY)) ) {
+            ++dropped_;
+            ++total_dropped_;
+        }
+    }
+
+    return reading_;
+}
+
+void FrameQueue::release()
+{
+    if (reading_ < 0)
+        return;
+
+    slot_[reading_] = SLOT(0, EMPTY);
+    reading_ = -1;
+}
+
+void FrameQueue::reset()
+{
+    for (unsigned int i = 0; i < size_; ++i)
+        slot_[i] = SLOT(0, EMPTY);
+    latest_ = -1;
+    write_index_ = 0;
+    writing_ = -1;
+    reading_ = -1;
+}
@@ -0,0 +1,83 @@
+#ifndef FRAMEQUEUE_H
+#define FRAMEQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+/**
+ * @brief The FrameQueue class
+ *
+ * Lock-free single-producer / single-consumer ring of frame slots,
+ * passing decoded frames from the gstreamer streaming thread (producer)
+ * to the rendering thread (consumer). The frames themselves are stored
+ * by the owner in an array of the same size; the queue only tells which
+ * slot to write or read, and neither thread ever waits for the other.
+ *
+ * Policy:
+ * - the consumer always reads the most recent frame published; older
+ *   unread frames are dropped (the producer can reuse their slots),
+ * - the producer writes in the next free slot; if all slots are unread,
+ *   the oldest unread frame is overwritten (the producer never blocks),
+ * - the slot being read is never written.
+ *
+ * Frames that are never read (dropped or overwritten) are counted, for
+ * each queue and for all queues.
+ */
+class FrameQueue
+{
+public:
+    FrameQueue(unsigned int size);
+    // non assignable class
+    FrameQueue(FrameQueue const&) = delete;
+    FrameQueue& operator=(FrameQueue const&) = delete;
+
+    inline unsigned int size() const { return size_; }
+
+    // producer: get index of slot to fill, publish it when filled
+    // or cancel if the frame is not valid (the slot is then free)
+    int write();
+    void publish();
+    void cancel();
+
+    // consumer: get index of the latest frame published (-1 if none
+    // since previous read), and release it when done
+    int read();
+    void release();
+
+    // free all slots (only when producer and consumer are idle)
+    void reset();
+
+    // statistics
+    inline uint64_t numDropped() const { return dropped_ + overwritten_; }
+    inline uint64_t numOverwritten() const { return overwritten_; }
+    static uint64_t totalDropped() { return total_dropped_ + total_overwritten_; }
+    static uint64_t totalOverwritten() { return total_overwritten_; }
+
+private:
+    typedef enum {
+        EMPTY = 0,
+        WRITING,
+        READY,
+        READING
+    } SlotState;
+
+    unsigned int size_;
+    std::unique_ptr< std::atomic<uint64_t>[] > slot_;
+    std::atomic<int> latest_;
+
+    // producer side
+    unsigned int write_index_;
+    int writing_;
+    uint64_t counter_;
+
+    // consumer side
+    int reading_;
+
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> overwritten_;
+    static std::atomic<uint64_t> total_dropped_;
+    static std::atomic<uint64_t> total_overwritten_;
+};
+
+#endif // FRAMEQUEUE_H
@@ -1,5 +1,6 @@
 #include <sstream>
 #include <iomanip>
+#include <cstring>
 using namespace std;
 
 #include <gst/gl/gl.h>
@@ -207,3 +208,23 @@ std::string GstToolkit::used_gpu_decoding_plugins(GstElement *gstbin)
     return found;
 }
 
+void GstToolkit::copy_video_frame(guint8 *dest, const GstVideoInfo *info, GstVideoFrame *frame)
+{
+    for (guint p = 0; p < GST_VIDEO_FRAME_N_PLANES(frame); ++p) {
+        const guint8 *src = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA(frame, p);
+        guint8 *dst = dest + GST_VIDEO_INFO_PLANE_OFFSET(info, p);
+        gint src_stride = GST_VIDEO_FRAME_PLANE_STRIDE(frame, p);
+        gint dst_stride = GST_VIDEO_INFO_PLANE_STRIDE(info, p);
+        // NB: component index is plane index for RGBA and I420
+        gint rows = GST_VIDEO_INFO_COMP_HEIGHT(info, p);
+
+        if (src_stride == dst_stride)
+            memcpy(dst, src, dst_stride * rows);
+        else {
+            // strides differ (decoder padding): copy line by line
+            gint len = MIN(src_stride, dst_stride);
+            for (gint r = 0; r < rows; ++r)
+                memcpy(dst + r * dst_stride, src + r * src_stride, len);
+        }
+    }
+}
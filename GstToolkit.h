@@ -2,6 +2,7 @@
 #define __GSTGUI_TOOLKIT_H_
 
 #include <gst/gst.h>
+#include <gst/video/video.h>
 
 #include <string>
 #include <list>
@@ -27,6 +28,9 @@ std::string used_gpu_decoding_plugins(GstElement *gstbin);
 std::list<std::string> all_plugin_features(std::string pluginname);
 bool enable_feature (std::string name, bool enable);
 
+// copy all planes of a mapped frame in memory, with the layout given by info
+void copy_video_frame(guint8 *dest, const GstVideoInfo *info, GstVideoFrame *frame);
+
 }
 
 #endif // __GSTGUI_TOOLKIT_H_
@@ -9,6 +9,8 @@
 
 ShadingProgram imageShadingProgram("shaders/image.vs", "shaders/image.fs");
 ShadingProgram imageAlphaProgram  ("shaders/image.vs", "shaders/imageblending.fs");
+ShadingProgram imageYUVProgram    ("shaders/image.vs", "shaders/imageyuv.fs");
+ShadingProgram patternProgram     ("shaders/image.vs", "shaders/pattern.fs");
 std::vector< ShadingProgram > maskPrograms = {
     ShadingProgram("shaders/simple.vs", "shaders/simple.fs"),
     ShadingProgram("shaders/image.vs",  "shaders/mask_draw.fs"),
@@ -82,6 +84,74 @@ AlphaShader::AlphaShader(): ImageShader()
 }
 
 
+YUVShader::YUVShader(): Shader(), u_texture(0), v_texture(0)
+{
+    // static program shader
+    program_ = &imageYUVProgram;
+    // reset instance
+    reset();
+}
+
+void YUVShader::use()
+{
+    Shader::use();
+
+    // set color matrix
+    program_->setUniform("coefficients", coefficients);
+    program_->setUniform("fullrange", fullrange);
+    program_->setUniform("layout", layout);
+
+    // setup chroma textures (iChannel0 is luma)
+    program_->setUniform("iChannel2", 2);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture  (GL_TEXTURE_2D, u_texture);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture  (GL_TEXTURE_2D, v_texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void YUVShader::reset()
+{
+    Shader::reset();
+
+    // default to ITU-R BT.601 in video range
+    coefficients = glm::vec2(0.299f, 0.114f);
+    fullrange = false;
+    layout = PLANAR;
+
+    // conversion replaces pixels
+    blending = Shader::BLEND_NONE;
+}
+
+
+PatternShader::PatternShader(): Shader(), pattern(0), time(0.f)
+{
+    // static program shader
+    program_ = &patternProgram;
+    // reset instance
+    reset();
+}
+
+void PatternShader::use()
+{
+    Shader::use();
+
+    program_->setUniform("pattern", pattern);
+    program_->setUniform("iTime", time);
+}
+
+void PatternShader::reset()
+{
+    Shader::reset();
+
+    pattern = 0;
+    time = 0.f;
+
+    // pattern replaces pixels
+    blending = Shader::BLEND_NONE;
+}
+
+
 MaskShader::MaskShader(): Shader(), mode(0)
 {
     // reset instance
@@ -35,6 +35,46 @@ public:
 
 };
 
+class YUVShader : public Shader
+{
+
+public:
+    YUVShader();
+
+    void use() override;
+    void reset() override;
+
+    // layout of pixels in textures
+    typedef enum {
+        PLANAR = 0,     // Y, U and V planes (e.g. I420)
+        SEMI_PLANAR,    // Y plane and interleaved UV plane (e.g. NV12)
+        PACKED          // two pixels in each RGBA texel (YUY2)
+    } Layout;
+
+    // chroma planes (luma, or packed pixels, is the texture of the surface)
+    uint u_texture;
+    uint v_texture;
+
+    // uniforms
+    glm::vec2 coefficients;
+    bool fullrange;
+    int layout;
+};
+
+class PatternShader : public Shader
+{
+
+public:
+    PatternShader();
+
+    void use() override;
+    void reset() override;
+
+    // uniforms
+    int pattern;
+    float time;
+};
+
 
 class MaskShader : public Shader
 {
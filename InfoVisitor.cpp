@@ -37,7 +37,7 @@
 #include "SystemToolkit.h"
 
 
-InfoVisitor::InfoVisitor() : brief_(true), current_id_(0)
+InfoVisitor::InfoVisitor() : brief_(true), current_id_(0), current_height_(0)
 {
 }
 
@@ -64,14 +64,16 @@ void InfoVisitor::visit(Primitive &n)
 
 void InfoVisitor::visit(MediaPlayer &mp)
 {
-    // do not ask twice
-    if (current_id_ == mp.id())
+    // do not ask twice (unless decoding resolution changed)
+    if (current_id_ == mp.id() && current_height_ == mp.decodeHeight())
         return;
 
     std::ostringstream oss;
     if (brief_) {
         oss << SystemToolkit::filename(mp.filename()) << std::endl;
         oss << mp.width() << " x " << mp.height() << ", ";
+        if (mp.decodeHeight() != mp.height())
+            oss << "decoding " << mp.decodeWidth() << " x " << mp.decodeHeight() << ", ";
         oss << mp.media().codec_name.substr(0, mp.media().codec_name.find_first_of(" (,"));
         if (!mp.isImage())
             oss << ", " << std::fixed << std::setprecision(1) << mp.frameRate() << " fps";
@@ -82,13 +84,17 @@ void InfoVisitor::visit(MediaPlayer &mp)
         oss << mp.width() << " x " << mp.height() ;
         if (!mp.isImage())
             oss << ", " << std::fixed << std::setprecision(1) << mp.frameRate() << " fps";
+        if (mp.decodeHeight() != mp.height())
+            oss << std::endl << "Decoding " << mp.decodeWidth() << " x " << mp.decodeHeight();
     }
 
     information_ = oss.str();
 
     // remember (except if codec was not identified yet)
-    if ( !mp.media().codec_name.empty() )
+    if ( !mp.media().codec_name.empty() ) {
         current_id_ = mp.id();
+        current_height_ = mp.decodeHeight();
+    }
 }
 
 void InfoVisitor::visit(Stream &n)
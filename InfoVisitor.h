@@ -8,6 +8,7 @@ class InfoVisitor : public Visitor
     std::string information_;
     bool brief_;
     uint64_t current_id_;
+    uint current_height_;
 
 public:
     InfoVisitor();
@@ -0,0 +1,167 @@
+#include <vector>
+#include <cstring>
+
+#include <stb_image.h>
+
+#include "DecoderThreads.h"
+#include "JpegDecoder.h"
+
+// Standard Huffman tables of the JPEG specification (Annex K.3), as a
+// DHT segment to insert in images which do not define their own tables
+static const guint8 standard_dht[] = {
+    0xff, 0xc4, 0x01, 0xa2,
+    // DC luminance
+    0x00,
+    0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+    // DC chrominance
+    0x01,
+    0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+    // AC luminance
+    0x10,
+    0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7d,
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+    0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+    0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+    0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+    0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa,
+    // AC chrominance
+    0x11,
+    0x00, 0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77,
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+    0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+    0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+    0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+    0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+    0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+    0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa,
+};
+
+// offset of the start of scan, if the image has no Huffman tables
+static gsize missing_huffman_tables(const guint8 *data, gsize size)
+{
+    // segments after start of image marker
+    gsize i = 2;
+    while ( i + 4 <= size && data[i] == 0xff ) {
+        guint8 marker = data[i + 1];
+        if ( marker == 0xc4 )
+            return 0;
+        if ( marker == 0xda )
+            return i;
+        i += 2 + ( (data[i + 2] << 8) | data[i + 3] );
+    }
+    return 0;
+}
+
+WorkerPool &JpegDecoder::pool()
+{
+    return DecoderThreads::pool();
+}
+
+JpegDecoder::JpegDecoder(guint width, guint height) : width_(width), height_(height)
+{
+    priority_ = WorkerPool::priority();
+}
+
+JpegDecoder::~JpegDecoder()
+{
+    flush();
+}
+
+GstBuffer *JpegDecoder::decode(GstBuffer *jpeg, guint width, guint height)
+{
+    GstMapInfo map;
+    if ( !gst_buffer_map(jpeg, &map, GST_MAP_READ) )
+        return nullptr;
+
+    int w = 0, h = 0, n = 0;
+    stbi_uc *img = nullptr;
+
+    // insert standard Huffman tables before start of scan if needed
+    gsize sos = map.size > 4 ? missing_huffman_tables(map.data, map.size) : 0;
+    if ( sos > 0 ) {
+        std::vector<guint8> data(map.size + sizeof(standard_dht));
+        memcpy(data.data(), map.data, sos);
+        memcpy(data.data() + sos, standard_dht, sizeof(standard_dht));
+        memcpy(data.data() + sos + sizeof(standard_dht), map.data + sos, map.size - sos);
+        img = stbi_load_from_memory(data.data(), (int) data.size(), &w, &h, &n, 4);
+    }
+    else
+        img = stbi_load_from_memory(map.data, (int) map.size, &w, &h, &n, 4);
+
+    gst_buffer_unmap(jpeg, &map);
+
+    if ( img == nullptr )
+        return nullptr;
+
+    // frame of another size cannot be given to the stream
+    if ( (guint) w != width || (guint) h != height ) {
+        stbi_image_free(img);
+        return nullptr;
+    }
+
+    // no copy: the buffer frees the image
+    gsize size = (gsize) w * h * 4;
+    GstBuffer *frame = gst_buffer_new_wrapped_full( (GstMemoryFlags) 0, img, size, 0, size, img, stbi_image_free );
+    gst_buffer_copy_into(frame, jpeg, GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+
+    return frame;
+}
+
+void JpegDecoder::push(GstBuffer *jpeg)
+{
+    // the job keeps a reference to the image (released even if cancelled)
+    std::shared_ptr<GstBuffer> image( gst_buffer_ref(jpeg), gst_buffer_unref );
+    guint w = width_;
+    guint h = height_;
+    pending_.push_back( pool().submit<GstBuffer *>( [image, w, h]() { return decode(image.get(), w, h); }, priority_ ) );
+}
+
+GstBuffer *JpegDecoder::pop(bool wait)
+{
+    if ( pending_.empty() )
+        return nullptr;
+
+    // wait for the oldest image if requested or if all workers are busy
+    if ( !wait && pending_.size() <= pool().numWorkers() &&
+         pending_.front().wait_for(std::chrono::seconds(0)) != std::future_status::ready )
+        return nullptr;
+
+    GstBuffer *frame = nullptr;
+    try {
+        frame = pending_.front().get();
+    }
+    catch (const std::future_error &) {
+        frame = nullptr;
+    }
+    pending_.pop_front();
+
+    return frame;
+}
+
+void JpegDecoder::flush()
+{
+    // cancel decoding not started, and wait for the others to finish
+    pool().cancel(priority_);
+    while ( !pending_.empty() ) {
+        try {
+            GstBuffer *frame = pending_.front().get();
+            if (frame)
+                gst_buffer_unref(frame);
+        }
+        catch (const std::future_error &) {
+        }
+        pending_.pop_front();
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef JPEGDECODER_H
+#define JPEGDECODER_H
+
+#include <deque>
+#include <future>
+
+#include <gst/gst.h>
+
+#include "WorkerPool.h"
+
+/**
+ * @brief The JpegDecoder class
+ *
+ * Decodes a stream of JPEG images (e.g. MJPEG capture device) in RGBA,
+ * in parallel on a pool of worker threads, and gives the frames back in
+ * order. A single decoder thread cannot keep up with 1080p at 60 fps.
+ *
+ * The images can be pushed as soon as they are received; the decoded
+ * frames are taken when ready, or waited for when too many images are
+ * being decoded (one per worker).
+ *
+ * Images of MJPEG streams often omit Huffman tables: the standard
+ * tables are then used.
+ */
+class JpegDecoder
+{
+public:
+    JpegDecoder(guint width, guint height);
+    ~JpegDecoder();
+    // non assignable class
+    JpegDecoder(JpegDecoder const&) = delete;
+    JpegDecoder& operator=(JpegDecoder const&) = delete;
+
+    /**
+     * Decode the JPEG image of the buffer (keeps a reference)
+     * */
+    void push(GstBuffer *jpeg);
+    /**
+     * Get the next frame decoded (with timestamps of the image),
+     * waiting for it if wait is true or if too many images are pending.
+     * returns nullptr if none (caller owns the buffer returned)
+     * */
+    GstBuffer *pop(bool wait = false);
+    /**
+     * Drop images pending
+     * */
+    void flush();
+
+private:
+    static GstBuffer *decode(GstBuffer *jpeg, guint width, guint height);
+
+    guint width_;
+    guint height_;
+    std::deque< std::future<GstBuffer *> > pending_;
+    WorkerPool::Priority priority_;
+
+    static WorkerPool &pool();
+};
+
+#endif // JPEGDECODER_H
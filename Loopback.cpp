@@ -13,6 +13,7 @@
 #include "SystemToolkit.h"
 #include "FrameBuffer.h"
 #include "Log.h"
+#include "DecoderThreads.h"
 
 #include "Loopback.h"
 
@@ -180,6 +181,9 @@ void Loopback::init(GstCaps *caps)
         return;
     }
 
+    // streaming threads run on all cores (if render thread is pinned)
+    DecoderThreads::unpinStreamingThreads(pipeline_);
+
     // setup device sink
     g_object_set (G_OBJECT (gst_bin_get_by_name (GST_BIN (pipeline_), "sink")),
                   "device", Loopback::system_loopback_name.c_str(),
@@ -0,0 +1,194 @@
+#include <fstream>
+
+#include <gst/app/gstappsrc.h>
+
+#include "defines.h"
+#include "Log.h"
+#include "BaseToolkit.h"
+#include "Settings.h"
+#include "WorkerPool.h"
+
+#include "MediaMemory.h"
+
+std::map< std::string, std::weak_ptr<MediaMemory> > MediaMemory::files_;
+std::mutex MediaMemory::registry_;
+std::atomic<guint64> MediaMemory::memory_(0);
+
+// one file read at a time (disk access is sequential)
+static WorkerPool &loading_pool()
+{
+    static WorkerPool _pool(1);
+    return _pool;
+}
+
+guint64 MediaMemory::budget()
+{
+    return static_cast<guint64>( MAX(Settings::application.render.media_memory_budget, 0) ) * 1048576;
+}
+
+std::shared_ptr<MediaMemory> MediaMemory::get(const std::string &filename)
+{
+    std::lock_guard<std::mutex> lock(registry_);
+
+    // already in memory (or loading)
+    std::shared_ptr<MediaMemory> m = files_[filename].lock();
+    if (m)
+        return m;
+
+    // new copy (private constructor)
+    m = std::shared_ptr<MediaMemory>( new MediaMemory(filename) );
+    files_[filename] = m;
+    return m;
+}
+
+MediaMemory::MediaMemory(const std::string &filename) : filename_(filename), size_(0),
+    loaded_(0), ready_(false), failed_(false), cancel_(false)
+{
+    std::ifstream file(filename_, std::ios::binary | std::ios::ate);
+    if ( !file.is_open() ) {
+        Log::Warning("Cannot load '%s' in RAM: file not readable.", filename_.c_str());
+        failed_ = true;
+        return;
+    }
+    size_ = file.tellg();
+
+    // reserve memory in budget (called under lock of registry)
+    if ( memory_ + size_ > budget() ) {
+        Log::Warning("Cannot load '%s' in RAM: %s over budget.", filename_.c_str(),
+                     BaseToolkit::byte_to_string(memory_ + size_ - budget()).c_str());
+        failed_ = true;
+        size_ = 0;
+        return;
+    }
+    memory_ += size_;
+
+    // allocate and read the file in background
+    priority_ = WorkerPool::priority();
+    loading_ = loading_pool().submit<void>( std::bind(&MediaMemory::load, this), priority_ );
+}
+
+MediaMemory::~MediaMemory()
+{
+    // cancel loading if not started, or stop reading (after current block)
+    cancel_ = true;
+    if (loading_.valid()) {
+        loading_pool().cancel(priority_);
+        loading_.wait();
+    }
+
+    // free budget (the data is freed when decoders release it)
+    memory_ -= size_;
+
+    std::lock_guard<std::mutex> lock(registry_);
+    auto f = files_.find(filename_);
+    if ( f != files_.end() && f->second.expired() )
+        files_.erase(f);
+}
+
+void MediaMemory::load()
+{
+    // not initialized: filled by reading the file
+    data_ = Data( (guint8 *) g_try_malloc( MAX(size_, 1) ), g_free );
+    if ( !data_ ) {
+        Log::Warning("Cannot load '%s' in RAM: out of memory.", filename_.c_str());
+        failed_ = true;
+        return;
+    }
+
+    std::ifstream file(filename_, std::ios::binary);
+
+    // read by blocks (can be cancelled)
+    while ( file.good() && !cancel_ && loaded_ < size_ ) {
+        std::streamsize n = (std::streamsize) MIN( (guint64) MEDIAMEMORY_BLOCK_SIZE, size_ - loaded_ );
+        file.read( (char *) data_.get() + loaded_, n );
+        loaded_ += file.gcount();
+    }
+
+    if ( loaded_ < size_ ) {
+        if ( !cancel_ ) {
+            Log::Warning("Cannot load '%s' in RAM: read error.", filename_.c_str());
+            failed_ = true;
+        }
+        return;
+    }
+
+    ready_ = true;
+    Log::Info("Media '%s' loaded in RAM (%s).", filename_.c_str(), BaseToolkit::byte_to_string(size_).c_str());
+}
+
+float MediaMemory::progress() const
+{
+    return size_ > 0 ? (float) ( (double) loaded_ / (double) size_ ) : 0.f;
+}
+
+///
+/// appsrc reading a MediaMemory (random access)
+///
+
+struct MemoryReader {
+    MediaMemory::Data data;
+    guint64 size;
+    std::atomic<guint64> offset;
+};
+
+static void reader_release_block(gpointer data)
+{
+    delete (MediaMemory::Data *) data;
+}
+
+static void reader_need_data(GstAppSrc *src, guint length, gpointer p)
+{
+    MemoryReader *reader = (MemoryReader *) p;
+    guint64 size = reader->size;
+    guint64 offset = reader->offset;
+
+    if ( offset >= size ) {
+        gst_app_src_end_of_stream (src);
+        return;
+    }
+
+    // block of requested length (if given) in the limit of the data
+    guint64 len = ( length > 0 && length < MEDIAMEMORY_BLOCK_SIZE ) ? length : MEDIAMEMORY_BLOCK_SIZE;
+    len = MIN( len, size - offset );
+
+    // no copy: the block keeps the data alive while in use
+    GstBuffer *buf = gst_buffer_new_wrapped_full( GST_MEMORY_FLAG_READONLY, reader->data.get(), size, offset, len,
+                                                  new MediaMemory::Data(reader->data), reader_release_block );
+    GST_BUFFER_OFFSET(buf) = offset;
+    reader->offset = offset + len;
+
+    gst_app_src_push_buffer (src, buf);
+}
+
+static gboolean reader_seek_data(GstAppSrc *, guint64 offset, gpointer p)
+{
+    MemoryReader *reader = (MemoryReader *) p;
+    reader->offset = offset;
+    return TRUE;
+}
+
+static void reader_free(gpointer p)
+{
+    delete (MemoryReader *) p;
+}
+
+void MediaMemory::setup_source(GstElement *, GstElement *source, gpointer memory)
+{
+    MediaMemory *m = (MediaMemory *) memory;
+    if ( !GST_IS_APP_SRC(source) || m == nullptr || !m->ready() )
+        return;
+
+    MemoryReader *reader = new MemoryReader;
+    reader->data = m->data_;
+    reader->size = m->size_;
+    reader->offset = 0;
+
+    GstAppSrcCallbacks callbacks = {};
+    callbacks.need_data = reader_need_data;
+    callbacks.seek_data = reader_seek_data;
+
+    gst_app_src_set_stream_type (GST_APP_SRC(source), GST_APP_STREAM_TYPE_RANDOM_ACCESS);
+    gst_app_src_set_size (GST_APP_SRC(source), (gint64) m->size_);
+    g_object_set (G_OBJECT (source), "format", GST_FORMAT_BYTES, NULL);
+    gst_app_src_set_callbacks (GST_APP_SRC(source), &callbacks, reader, reader_free);
+}
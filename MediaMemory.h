@@ -0,0 +1,90 @@
+#ifndef MEDIAMEMORY_H
+#define MEDIAMEMORY_H
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <future>
+#include <vector>
+#include <map>
+#include <string>
+
+#include <gst/gst.h>
+
+#include "WorkerPool.h"
+
+// size of blocks read from disk and given to the decoder
+#define MEDIAMEMORY_BLOCK_SIZE (4 * 1048576)
+
+/**
+ * @brief The MediaMemory class
+ *
+ * Copy in RAM of the bytes of a media file, read once in background;
+ * once loaded, the media player decodes from memory (with an appsrc in
+ * place of the file source) and the disk is not accessed anymore.
+ *
+ * Media players of the same file share the same copy. All copies share
+ * a global memory budget (Settings); a file which does not fit in the
+ * budget is not loaded (the media player keeps reading from disk).
+ */
+class MediaMemory
+{
+public:
+    typedef std::shared_ptr<guint8> Data;
+
+    /**
+     * Get the copy of the file (loading starts at first request)
+     * */
+    static std::shared_ptr<MediaMemory> get(const std::string &filename);
+    ~MediaMemory();
+    // non assignable class
+    MediaMemory(MediaMemory const&) = delete;
+    MediaMemory& operator=(MediaMemory const&) = delete;
+
+    /**
+     * True when all bytes of the file are in memory
+     * */
+    inline bool ready() const { return ready_; }
+    /**
+     * True if the file cannot be loaded (unreadable or over budget)
+     * */
+    inline bool failed() const { return failed_; }
+    /**
+     * Fraction of the file loaded [0 1]
+     * */
+    float progress() const;
+    /**
+     * Size of the file in bytes
+     * */
+    inline guint64 size() const { return size_; }
+    /**
+     * Callback for signal 'source-setup' of uridecodebin (uri 'appsrc://'):
+     * configures the appsrc to read the data of this MediaMemory
+     * */
+    static void setup_source(GstElement *bin, GstElement *source, gpointer memory);
+
+    // shared engine
+    static guint64 budget();
+    static guint64 memoryUsage() { return memory_; }
+
+private:
+    MediaMemory(const std::string &filename);
+    void load();
+
+    std::string filename_;
+    Data data_;
+    guint64 size_;
+    std::atomic<guint64> loaded_;
+    std::atomic<bool> ready_;
+    std::atomic<bool> failed_;
+    std::atomic<bool> cancel_;
+    std::future<void> loading_;
+    WorkerPool::Priority priority_;
+
+    // global list of files in memory
+    static std::map< std::string, std::weak_ptr<MediaMemory> > files_;
+    static std::mutex registry_;
+    static std::atomic<guint64> memory_;
+};
+
+#endif // MEDIAMEMORY_H
@@ -1,10 +1,21 @@
 #include <thread>
+#include <map>
+#include <sstream>
+#include <algorithm>
 
 using namespace std;
 
+#include <tinyxml2.h>
+#include "tinyxml2Toolkit.h"
+using namespace tinyxml2;
+
 //  Desktop OpenGL function loader
 #include <glad/glad.h>
 
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <stb_image.h>
+
 
 // vmix
 #include "defines.h"
@@ -15,6 +26,15 @@ using namespace std;
 #include "BaseToolkit.h"
 #include "GstToolkit.h"
 #include "RenderingManager.h"
+#include "Settings.h"
+#include "FrameBuffer.h"
+#include "Primitives.h"
+#include "ImageShader.h"
+#include "PixelBufferRing.h"
+#include "FrameCache.h"
+#include "ReverseDecoder.h"
+#include "MediaMemory.h"
+#include "DecoderThreads.h"
 
 #include "MediaPlayer.h"
 
@@ -23,35 +43,80 @@ using namespace std;
 #endif
 
 std::list<MediaPlayer*> MediaPlayer::registered_;
+std::list<MediaPlayer*> MediaPlayer::sync_waiting_;
+GstClockTime MediaPlayer::sync_timeout_ = GST_CLOCK_TIME_NONE;
+std::atomic<guint64> MediaPlayer::image_memory_(0);
+std::atomic<guint> MediaPlayer::max_image_size_(0);
 
-MediaPlayer::MediaPlayer()
+MediaPlayer::MediaPlayer() : frame_queue_(N_VFRAME)
 {
     // create unique id
     id_ = BaseToolkit::uniqueId();
 
     uri_ = "undefined";
     pipeline_ = nullptr;
+    sink_caps_ = nullptr;
+    starting_ = false;
     opened_ = false;
     enabled_ = true;
+    suspended_ = false;
+    resume_position_ = GST_CLOCK_TIME_NONE;
     desired_state_ = GST_STATE_PAUSED;
 
     failed_ = false;
     seeking_ = false;
+    segmented_ = false;
+    sync_group_ = GST_CLOCK_TIME_NONE;
+    sync_base_ = GST_CLOCK_TIME_NONE;
+    sync_offset_ = 0;
+    sync_requested_ = false;
+    sync_prerolled_ = false;
     force_software_decoding_ = false;
     decoder_name_ = "";
     rate_ = 1.0;
     position_ = GST_CLOCK_TIME_NONE;
     loop_ = LoopMode::LOOP_REWIND;
 
-    // start index in frame_ stack
-    write_index_ = 0;
-    last_index_ = 0;
-
-    // no PBO by default
-    pbo_[0] = pbo_[1] = 0;
-    pbo_size_ = 0;
-    pbo_index_ = 0;
-    pbo_next_index_ = 0;
+    // not shared
+    leader_ = nullptr;
+
+    // decode at full resolution until display size is known
+    display_height_ = 0;
+    decode_level_ = 0;
+    decode_width_ = 0;
+    decode_height_ = 0;
+    decode_level_target_ = 0;
+    decode_level_time_ = 0;
+
+    // normal loading priority, index last
+    load_priority_ = WorkerPool::priority(MediaPlayer::LOAD_NORMAL);
+    index_priority_ = WorkerPool::priority(MediaPlayer::LOAD_INDEX);
+
+    // no cache by default
+    cache_ = nullptr;
+    cache_enabled_ = false;
+    cache_specified_ = false;
+    cache_last_pts_ = GST_CLOCK_TIME_NONE;
+    cache_loops_ = 0;
+    cached_ = false;
+    cached_pts_ = GST_CLOCK_TIME_NONE;
+    cached_time_ = 0;
+    reverse_ = nullptr;
+    reversed_ = false;
+    frame_texture_ = 0;
+    image_loading_level_ = 0;
+    image_bytes_ = 0;
+    memory_enabled_ = false;
+    memory_reading_ = false;
+
+    // no PBO ring by default
+    pbo_ring_ = nullptr;
+
+    // RGBA frames by default
+    yuv_ = false;
+    yuv_textures_[0] = yuv_textures_[1] = 0;
+    yuv_buffer_ = nullptr;
+    yuv_surface_ = nullptr;
 
     // OpenGL texture
     textureindex_ = 0;
@@ -61,13 +126,12 @@ MediaPlayer::~MediaPlayer()
 {
     close();
 
-    // cleanup opengl texture
-    if (textureindex_)
-        glDeleteTextures(1, &textureindex_);
+    // cleanup opengl textures and buffers
+    release_texture();
 
-    // cleanup picture buffer
-    if (pbo_[0])
-        glDeleteBuffers(2, pbo_);
+    // cleanup persistent upload ring
+    if (pbo_ring_)
+        delete pbo_ring_.load();
 }
 
 void MediaPlayer::accept(Visitor& v) {
@@ -76,33 +140,496 @@ void MediaPlayer::accept(Visitor& v) {
 
 guint MediaPlayer::texture() const
 {
+    // shared decoding: texture of the leader
+    if (leader_)
+        return leader_->texture();
+
     if (textureindex_ == 0)
         return Resource::getTextureBlack();
 
+    // playing animation from textures of frames
+    if (cached_ && frame_texture_ > 0)
+        return frame_texture_;
+
+    // YUV planes are converted into the RGB frame buffer
+    if (yuv_buffer_)
+        return yuv_buffer_->texture();
+
     return textureindex_;
 }
 
-#define LIMIT_DISCOVERER
+// Discovery of media runs in a bounded number of threads (one per core),
+// the most urgent sources first (see setLoadPriority); running a
+// discoverer for every source of a session at once would lead to a peak
+// of memory and CPU usage, slowing down the rendering.
+static WorkerPool &discoverer_pool()
+{
+    static WorkerPool _pool;
+    return _pool;
+}
+
+// Indexing of keyframes demuxes the whole file: a single scan at a time,
+// in its own thread, so that it never delays the discovery of media.
+static WorkerPool &index_pool()
+{
+    static WorkerPool _pool(1);
+    return _pool;
+}
 
-MediaInfo MediaPlayer::UriDiscoverer(const std::string &uri)
+// On-disk cache of discoverer results, for files unchanged since discovery
+#define DISCOVERER_CACHE_FILE "discoverer.xml"
+#define DISCOVERER_CACHE_MAX 1000
+
+struct DiscovererCacheEntry {
+    unsigned long long size;
+    long long mtime;
+    gint64 used;
+    MediaInfo info;
+    bool indexed;
+    std::vector<GstClockTime> keyframes;
+    DiscovererCacheEntry() : size(0), mtime(0), used(0), indexed(false) {}
+};
+
+static std::map<std::string, DiscovererCacheEntry> discoverer_cache_;
+static std::mutex discoverer_cache_lock_;
+static bool discoverer_cache_loaded_ = false;
+static bool discoverer_cache_changed_ = false;
+
+static std::string discoverer_cache_path(const std::string &uri)
+{
+    std::string path;
+    if ( gst_uri_has_protocol(uri.c_str(), "file") ) {
+        gchar *location = gst_uri_get_location(uri.c_str());
+        if (location) {
+            path = std::string(location);
+            g_free(location);
+        }
+    }
+    return path;
+}
+
+// NB: call with discoverer_cache_lock_ locked
+static void discoverer_cache_load()
+{
+    discoverer_cache_loaded_ = true;
+
+    XMLDocument xmlDoc;
+    std::string filename = SystemToolkit::full_filename(SystemToolkit::settings_path(), DISCOVERER_CACHE_FILE);
+    if ( xmlDoc.LoadFile(filename.c_str()) != XML_SUCCESS )
+        return;
+
+    XMLElement *pRoot = xmlDoc.FirstChildElement("DiscovererCache");
+    if (pRoot == nullptr)
+        return;
+
+    XMLElement* media = pRoot->FirstChildElement("Media");
+    for( ; media ; media = media->NextSiblingElement()) {
+        const char *path = media->Attribute("path");
+        if (!path)
+            continue;
+        DiscovererCacheEntry e;
+        uint64_t size = 0;
+        int64_t mtime = 0, used = 0;
+        media->QueryUnsigned64Attribute("size", &size);
+        media->QueryInt64Attribute("mtime", &mtime);
+        media->QueryInt64Attribute("used", &used);
+        e.size = size;
+        e.mtime = mtime;
+        e.used = used;
+        media->QueryUnsignedAttribute("width", &e.info.width);
+        media->QueryUnsignedAttribute("par_width", &e.info.par_width);
+        media->QueryUnsignedAttribute("height", &e.info.height);
+        media->QueryUnsignedAttribute("bitrate", &e.info.bitrate);
+        media->QueryUnsignedAttribute("framerate_n", &e.info.framerate_n);
+        media->QueryUnsignedAttribute("framerate_d", &e.info.framerate_d);
+        const char *codec = media->Attribute("codec");
+        if (codec)
+            e.info.codec_name = std::string(codec);
+        media->QueryBoolAttribute("isimage", &e.info.isimage);
+        media->QueryBoolAttribute("interlaced", &e.info.interlaced);
+        media->QueryBoolAttribute("seekable", &e.info.seekable);
+        uint64_t dt = GST_CLOCK_TIME_NONE, end = GST_CLOCK_TIME_NONE;
+        media->QueryUnsigned64Attribute("dt", &dt);
+        media->QueryUnsigned64Attribute("end", &end);
+        e.info.dt = dt;
+        e.info.end = end;
+        e.info.valid = true;
+        XMLElement* index = media->FirstChildElement("Keyframes");
+        if (index) {
+            e.indexed = true;
+            const char *text = index->GetText();
+            if (text) {
+                std::istringstream iss(text);
+                unsigned long long k = 0;
+                while (iss >> k)
+                    e.keyframes.push_back( (GstClockTime) k );
+            }
+        }
+        discoverer_cache_[std::string(path)] = e;
+    }
+}
+
+// NB: call with discoverer_cache_lock_ locked
+static void discoverer_cache_save()
+{
+    XMLDocument xmlDoc;
+    XMLElement *pRoot = xmlDoc.NewElement("DiscovererCache");
+    xmlDoc.InsertEndChild(pRoot);
+
+    for (auto it = discoverer_cache_.cbegin(); it != discoverer_cache_.cend(); ++it) {
+        const DiscovererCacheEntry &e = it->second;
+        XMLElement *media = xmlDoc.NewElement("Media");
+        media->SetAttribute("path", it->first.c_str());
+        media->SetAttribute("size", (uint64_t) e.size);
+        media->SetAttribute("mtime", (int64_t) e.mtime);
+        media->SetAttribute("used", (int64_t) e.used);
+        media->SetAttribute("width", e.info.width);
+        media->SetAttribute("par_width", e.info.par_width);
+        media->SetAttribute("height", e.info.height);
+        media->SetAttribute("bitrate", e.info.bitrate);
+        media->SetAttribute("framerate_n", e.info.framerate_n);
+        media->SetAttribute("framerate_d", e.info.framerate_d);
+        media->SetAttribute("codec", e.info.codec_name.c_str());
+        media->SetAttribute("isimage", e.info.isimage);
+        media->SetAttribute("interlaced", e.info.interlaced);
+        media->SetAttribute("seekable", e.info.seekable);
+        media->SetAttribute("dt", (uint64_t) e.info.dt);
+        media->SetAttribute("end", (uint64_t) e.info.end);
+        if (e.indexed) {
+            XMLElement *index = xmlDoc.NewElement("Keyframes");
+            std::ostringstream oss;
+            for (auto k = e.keyframes.cbegin(); k != e.keyframes.cend(); ++k)
+                oss << (unsigned long long) *k << ' ';
+            index->SetText( oss.str().c_str() );
+            media->InsertEndChild(index);
+        }
+        pRoot->InsertEndChild(media);
+    }
+
+    std::string filename = SystemToolkit::full_filename(SystemToolkit::settings_path(), DISCOVERER_CACHE_FILE);
+    XMLSaveDoc(&xmlDoc, filename);
+}
+
+static bool discoverer_cache_get(const std::string &uri, MediaInfo &info)
+{
+    std::string path = discoverer_cache_path(uri);
+    unsigned long long size = 0;
+    long long mtime = 0;
+    if ( !SystemToolkit::file_status(path, size, mtime) )
+        return false;
+
+    std::lock_guard<std::mutex> lock(discoverer_cache_lock_);
+    if (!discoverer_cache_loaded_)
+        discoverer_cache_load();
+
+    // known file, not modified since
+    auto it = discoverer_cache_.find(path);
+    if ( it == discoverer_cache_.end() || it->second.size != size || it->second.mtime != mtime )
+        return false;
+
+    it->second.used = g_get_real_time();
+    info = it->second.info;
+    return true;
+}
+
+static void discoverer_cache_set(const std::string &uri, const MediaInfo &info)
+{
+    std::string path = discoverer_cache_path(uri);
+    DiscovererCacheEntry e;
+    if ( !info.valid || !SystemToolkit::file_status(path, e.size, e.mtime) )
+        return;
+    e.used = g_get_real_time();
+    e.info = info;
+
+    std::lock_guard<std::mutex> lock(discoverer_cache_lock_);
+    if (!discoverer_cache_loaded_)
+        discoverer_cache_load();
+
+    // keep keyframes index of unchanged file
+    auto previous = discoverer_cache_.find(path);
+    if ( previous != discoverer_cache_.end() && previous->second.size == e.size && previous->second.mtime == e.mtime ) {
+        e.indexed = previous->second.indexed;
+        e.keyframes = previous->second.keyframes;
+    }
+    discoverer_cache_[path] = e;
+
+    // forget least recently used files
+    while (discoverer_cache_.size() > DISCOVERER_CACHE_MAX) {
+        auto oldest = discoverer_cache_.begin();
+        for (auto it = discoverer_cache_.begin(); it != discoverer_cache_.end(); ++it) {
+            if (it->second.used < oldest->second.used)
+                oldest = it;
+        }
+        discoverer_cache_.erase(oldest);
+    }
+
+    // written once when quitting (see saveDiscovererCache)
+    discoverer_cache_changed_ = true;
+}
+
+static bool keyframes_cache_get(const std::string &uri, std::vector<GstClockTime> &keyframes)
+{
+    std::string path = discoverer_cache_path(uri);
+    unsigned long long size = 0;
+    long long mtime = 0;
+    if ( !SystemToolkit::file_status(path, size, mtime) )
+        return false;
+
+    std::lock_guard<std::mutex> lock(discoverer_cache_lock_);
+    if (!discoverer_cache_loaded_)
+        discoverer_cache_load();
+
+    // known file, indexed and not modified since
+    auto it = discoverer_cache_.find(path);
+    if ( it == discoverer_cache_.end() || !it->second.indexed || it->second.size != size || it->second.mtime != mtime )
+        return false;
+
+    keyframes = it->second.keyframes;
+    return true;
+}
+
+static void keyframes_cache_set(const std::string &uri, const std::vector<GstClockTime> &keyframes)
 {
+    std::string path = discoverer_cache_path(uri);
+    unsigned long long size = 0;
+    long long mtime = 0;
+    if ( !SystemToolkit::file_status(path, size, mtime) )
+        return;
+
+    std::lock_guard<std::mutex> lock(discoverer_cache_lock_);
+    if (!discoverer_cache_loaded_)
+        discoverer_cache_load();
+
+    // index goes with the discoverer info of the same file
+    auto it = discoverer_cache_.find(path);
+    if ( it == discoverer_cache_.end() || it->second.size != size || it->second.mtime != mtime )
+        return;
+
+    it->second.indexed = true;
+    it->second.keyframes = keyframes;
+
+    // written once when quitting (see saveDiscovererCache)
+    discoverer_cache_changed_ = true;
+}
+
+void MediaPlayer::saveDiscovererCache()
+{
+    std::lock_guard<std::mutex> lock(discoverer_cache_lock_);
+    if (discoverer_cache_changed_) {
+        discoverer_cache_save();
+        discoverer_cache_changed_ = false;
+    }
+}
+
+static void keyframes_pad_added(GstElement *, GstPad *pad, gpointer data)
+{
+    GstElement *sink = GST_ELEMENT(data);
+    GstPad *sinkpad = gst_element_get_static_pad(sink, "sink");
+
+    GstCaps *caps = gst_pad_query_caps(pad, NULL);
+    const gchar *name = gst_structure_get_name( gst_caps_get_structure(caps, 0) );
+
+    // first video stream goes to the sink
+    if ( g_str_has_prefix(name, "video/") && !gst_pad_is_linked(sinkpad) )
+        gst_pad_link(pad, sinkpad);
+    // other streams are discarded
+    else {
+        GstElement *bin = GST_ELEMENT( gst_element_get_parent(sink) );
+        GstElement *fakesink = gst_element_factory_make("fakesink", NULL);
+        g_object_set(fakesink, "sync", FALSE, NULL);
+        gst_bin_add(GST_BIN(bin), fakesink);
+        gst_element_sync_state_with_parent(fakesink);
+        GstPad *fakepad = gst_element_get_static_pad(fakesink, "sink");
+        gst_pad_link(pad, fakepad);
+        gst_object_unref(fakepad);
+        gst_object_unref(bin);
+    }
+
+    gst_caps_unref(caps);
+    gst_object_unref(sinkpad);
+}
+
+std::vector<GstClockTime> MediaPlayer::UriKeyframes(const std::string &uri)
+{
+    std::vector<GstClockTime> keyframes;
+
+    // file unchanged since last index
+    if ( keyframes_cache_get(uri, keyframes) )
+        return keyframes;
+
+    // demux without decoding, and read the frames flagged as keyframes
+    std::string description = "urisourcebin uri=" + uri + " ! parsebin name=parser";
+    GError *error = NULL;
+    GstElement *pipeline = gst_parse_launch (description.c_str(), &error);
+    if (error != NULL) {
+        g_clear_error (&error);
+        if (pipeline)
+            gst_object_unref (pipeline);
+        return keyframes;
+    }
+
+    GstElement *sink = gst_element_factory_make("appsink", NULL);
+    g_object_set(sink, "sync", FALSE, "max-buffers", 50, NULL);
+    gst_bin_add(GST_BIN(pipeline), sink);
+    GstElement *parser = gst_bin_get_by_name (GST_BIN (pipeline), "parser");
+    g_signal_connect(parser, "pad-added", G_CALLBACK(keyframes_pad_added), sink);
+    gst_object_unref (parser);
+
+    bool failed = gst_element_set_state (pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE;
+    size_t numframes = 0;
+    GstBus *bus = gst_element_get_bus(pipeline);
+    while ( !failed ) {
+        GstSample *sample = gst_app_sink_try_pull_sample (GST_APP_SINK(sink), 100 * GST_MSECOND);
+        if (sample) {
+            GstBuffer *buf = gst_sample_get_buffer (sample);
+            if ( buf && !GST_BUFFER_FLAG_IS_SET(buf, GST_BUFFER_FLAG_DELTA_UNIT) ) {
+                GstClockTime t = GST_BUFFER_PTS_IS_VALID(buf) ? GST_BUFFER_PTS(buf) : GST_BUFFER_DTS(buf);
+                if ( GST_CLOCK_TIME_IS_VALID(t) )
+                    keyframes.push_back(t);
+            }
+            ++numframes;
+            gst_sample_unref (sample);
+        }
+        else if ( gst_app_sink_is_eos (GST_APP_SINK(sink)) )
+            break;
+        else {
+            GstMessage *msg = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+            if (msg) {
+                failed = true;
+                gst_message_unref(msg);
+            }
+        }
+    }
+    gst_object_unref(bus);
+
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+    gst_object_unref (pipeline);
+
+    if (failed || numframes < 1)
+        return std::vector<GstClockTime>();
+
+    // all frames are keyframes: any seek is cheap, no need for index
+    if (keyframes.size() > numframes / 2)
+        keyframes.clear();
+
 #ifdef MEDIA_PLAYER_DEBUG
-    Log::Info("Checking file '%s'", uri.c_str());
+    Log::Info("Indexed %d keyframes in %d frames of '%s'", (int) keyframes.size(), (int) numframes, uri.c_str());
 #endif
 
-#ifdef LIMIT_DISCOVERER
-    // Limiting the number of discoverer thread to TWO in parallel
-    // Otherwise, a large number of discoverers are executed (when loading a file)
-    // leading to a peak of memory and CPU usage : this causes slow down of FPS
-    // and a hungry consumption of RAM.
-    static std::mutex mtx_primary;
-    static std::mutex mtx_secondary;
-    bool use_primary = true;
-    if ( !mtx_primary.try_lock() ) { // non-blocking
-        use_primary = false;
-        mtx_secondary.lock(); // blocking
+    // remember for next time
+    keyframes_cache_set(uri, keyframes);
+
+    return keyframes;
+}
+
+// still images of common formats are decoded without gstreamer (local files)
+static bool still_image_file(const std::string &uri)
+{
+    if ( !gst_uri_has_protocol(uri.c_str(), "file") )
+        return false;
+
+    std::string ext = SystemToolkit::extension_filename(uri);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == "jpg" || ext == "jpeg" || ext == "png" || ext == "bmp" || ext == "tga";
+}
+
+// finest level of reduction of an image of w x h fitting in a texture and
+// in the budget of image textures (with mipmaps), given the memory of others
+static guint image_level(guint w, guint h, guint64 others)
+{
+    guint64 budget = static_cast<guint64>( MAX(Settings::application.render.image_texture_budget, 0) ) * 1048576;
+
+    guint level = 0;
+    while ( level < MEDIA_IMAGE_MAX_LEVEL &&
+            ( ( MAX(w, h) >> level ) > MediaPlayer::maxImageSize() ||
+              others + (guint64) (w >> level) * (h >> level) * 16 / 3 > budget ) )
+        ++level;
+
+    return level;
+}
+
+// decode still image in RGBA pixels (in a worker thread), reduced by 2^level
+// (or more if the image does not fit in a texture or in the budget, given the
+// memory of other images); gives size of the image and the level of the pixels
+static bool decode_still_image(const std::string &uri, guint level, guint64 others, std::vector<guint8> *pixels,
+                               guint *width, guint *height, guint *decoded_level)
+{
+    gchar *location = gst_uri_get_location(uri.c_str());
+    if (location == NULL)
+        return false;
+
+    int w = 0, h = 0, n = 0;
+    stbi_uc *img = stbi_load(location, &w, &h, &n, 4);
+    g_free(location);
+    if (img == NULL)
+        return false;
+    *width = w;
+    *height = h;
+
+    // level fitting in a texture and in the budget
+    level = MAX( level, image_level(w, h, others) );
+
+    // reduce by half until level (average of 2 x 2 pixels)
+    std::vector<guint8> reduced;
+    const guint8 *src = img;
+    guint sw = w, sh = h, l = 0;
+    for (; l < level && sw > 1 && sh > 1; ++l) {
+        guint dw = sw / 2, dh = sh / 2;
+        std::vector<guint8> dst( (size_t) dw * dh * 4 );
+        for (guint y = 0; y < dh; ++y) {
+            const guint8 *r0 = src + (size_t) (2 * y) * sw * 4;
+            const guint8 *r1 = r0 + (size_t) sw * 4;
+            guint8 *d = dst.data() + (size_t) y * dw * 4;
+            for (guint x = 0; x < dw * 4; x += 4) {
+                for (guint c = 0; c < 4; ++c)
+                    d[x + c] = (r0[2 * x + c] + r0[2 * x + 4 + c] + r1[2 * x + c] + r1[2 * x + 4 + c] + 2) / 4;
+            }
+        }
+        reduced.swap(dst);
+        src = reduced.data();
+        sw = dw;
+        sh = dh;
+    }
+    *decoded_level = l;
+
+    if (l > 0)
+        pixels->swap(reduced);
+    else
+        pixels->assign(img, img + (size_t) w * (size_t) h * 4);
+    stbi_image_free(img);
+
+    return true;
+}
+
+// decode still image (in a worker thread) or discover
+// it with gstreamer if the decoder does not support it
+static MediaInfo image_decoder(const std::string &uri, std::vector<guint8> *pixels, guint *level)
+{
+    MediaInfo info;
+    if ( !decode_still_image(uri, 0, MediaPlayer::imageMemoryUsage(), pixels, &info.width, &info.height, level) ) {
+        Log::Info("Image '%s' opened with gstreamer (%s)", uri.c_str(), stbi_failure_reason());
+        return MediaPlayer::UriDiscoverer(uri);
     }
+
+    info.par_width = info.width;
+    info.codec_name = "image/" + SystemToolkit::extension_filename(uri);
+    info.isimage = true;
+    info.valid = true;
+
+    return info;
+}
+
+MediaInfo MediaPlayer::UriDiscoverer(const std::string &uri)
+{
+    // file unchanged since last discovery: skip discovery
+    MediaInfo cached_info;
+    if ( discoverer_cache_get(uri, cached_info) )
+        return cached_info;
+
+#ifdef MEDIA_PLAYER_DEBUG
+    Log::Info("Checking file '%s'", uri.c_str());
 #endif
+
     MediaInfo video_stream_info;
     GError *err = NULL;
     GstDiscoverer *discoverer = gst_discoverer_new (15 * GST_SECOND, &err);
@@ -211,12 +738,9 @@ MediaInfo MediaPlayer::UriDiscoverer(const std::string &uri)
 
     g_clear_error (&err);
 
-#ifdef LIMIT_DISCOVERER
-    if (use_primary)
-        mtx_primary.unlock();
-    else
-        mtx_secondary.unlock();
-#endif
+    // remember for next time
+    discoverer_cache_set(uri, video_stream_info);
+
     // return the info
     return video_stream_info;
 }
@@ -236,8 +760,17 @@ void MediaPlayer::open (const std::string & filename, const string &uri)
     if (isOpen())
         close();
 
-    // start URI discovering thread:
-    discoverer_ = std::async( MediaPlayer::UriDiscoverer, uri_);
+    // copy of the new file in RAM
+    memory_.reset();
+    if (memory_enabled_)
+        setMemoryEnabled(true);
+
+    // queue URI discovering in thread pool:
+    // (still images are decoded at once, no pipeline needed)
+    if ( still_image_file(uri_) )
+        discoverer_ = discoverer_pool().submit<MediaInfo>( std::bind(image_decoder, uri_, &image_, &image_loading_level_), load_priority_);
+    else
+        discoverer_ = discoverer_pool().submit<MediaInfo>( std::bind(MediaPlayer::UriDiscoverer, uri_), load_priority_);
     // wait for discoverer to finish in the future (test in update)
 
 //    // debug without thread
@@ -261,8 +794,88 @@ void MediaPlayer::reopen()
     }
 }
 
+bool MediaPlayer::join()
+{
+    // find a leader decoding the same media with the same playback
+    for (auto it = registered_.cbegin(); it != registered_.cend(); ++it) {
+        MediaPlayer *m = *it;
+        if ( m != this && m->leader_ == nullptr && m->pipeline_ != nullptr &&
+             m->opened_ && !m->failed_ && m->enabled_ &&
+             m->uri_.compare(uri_) == 0 &&
+             m->rate_ == rate_ && m->loop_ == loop_ &&
+             m->desired_state_ == desired_state_ &&
+             m->force_software_decoding_ == force_software_decoding_ &&
+             m->memory_enabled_ == memory_enabled_ &&
+             m->timeline_.equivalent(timeline_) ) {
+
+            // follow this leader
+            leader_ = m;
+            m->followers_.push_back(this);
+
+            Log::Info("MediaPlayer %s Shares decoding of '%s' with %s", std::to_string(id_).c_str(),
+                      uri_.c_str(), std::to_string(m->id_).c_str());
+
+            // ready and registered, without pipeline
+            opened_ = true;
+            MediaPlayer::registered_.push_back(this);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MediaPlayer::split()
+{
+    if (leader_ == nullptr)
+        return;
+
+    // leave the leader
+    leader_->followers_.remove(this);
+    leader_ = nullptr;
+
+    // open own pipeline (registers again)
+    GstClockTime pos = position_;
+    opened_ = false;
+    MediaPlayer::registered_.remove(this);
+    execute_open();
+
+#ifdef MEDIA_PLAYER_DEBUG
+    Log::Info("MediaPlayer %s Stops sharing decoding", std::to_string(id_).c_str());
+#endif
+
+    // continue from the position of the leader
+    // (seek is done by update() once pre-rolled, never waiting here)
+    if ( opened_ && pos != GST_CLOCK_TIME_NONE )
+        resume_position_ = pos;
+}
+
+void MediaPlayer::diverge()
+{
+    // a follower goes its own way
+    if (leader_)
+        split();
+    // a leader lets its followers go on without it:
+    // the first becomes leader of the others
+    else if (!followers_.empty()) {
+        std::list<MediaPlayer *> followers;
+        followers.swap(followers_);
+        MediaPlayer *next = followers.front();
+        followers.pop_front();
+        next->split();
+        for (auto it = followers.begin(); it != followers.end(); ++it) {
+            (*it)->leader_ = next;
+            next->followers_.push_back(*it);
+        }
+    }
+}
+
 void MediaPlayer::execute_open() 
 {   
+    // no segment until first seek
+    segment_.reset();
+    segmented_ = false;
+
     // Create gstreamer pipeline :
     //         "uridecodebin uri=file:///path_to_file/filename.mp4 ! videoconvert ! appsink "
     // equivalent to command line
@@ -283,6 +896,20 @@ void MediaPlayer::execute_open()
     if (media_.interlaced)
         description += "deinterlace method=2 ! ";
 
+    // decode resolution: full size of media, or scaled down by 2^level
+    // (done before colorspace conversion, so that it converts less pixels)
+    // NB: the caps of the 'scale' filter are changed to set the decode level
+    // at runtime (videoscale is passthrough at full size)
+    decode_width_  = media_.width;
+    decode_height_ = media_.height;
+    if (!media_.isimage) {
+        if (decode_level_ > 0) {
+            decode_width_  = MAX( 2u, (media_.width  >> decode_level_) & ~1u );
+            decode_height_ = MAX( 2u, (media_.height >> decode_level_) & ~1u );
+        }
+        description += "videoscale ! capsfilter name=scale ! ";
+    }
+
     // video convertion algorithm (should only do colorspace conversion, no scaling)
     // chroma-resampler:
     //      Duplicates the samples when upsampling and drops when downsampling 0
@@ -307,6 +934,14 @@ void MediaPlayer::execute_open()
     // set app sink
     description += "appsink name=sink";
 
+    // keep description (reading the file) for other decoders of this media
+    description_ = description;
+
+    // decode from the copy of the file in RAM (if loaded)
+    memory_reading_ = memory_ != nullptr && memory_->ready();
+    if (memory_reading_)
+        description.replace( description.find(uri_), uri_.size(), "appsrc://" );
+
     // parse pipeline descriptor
     GError *error = NULL;
     pipeline_ = gst_parse_launch (description.c_str(), &error);
@@ -320,21 +955,53 @@ void MediaPlayer::execute_open()
     g_object_set(G_OBJECT(pipeline_), "name", std::to_string(id_).c_str(), NULL);
     gst_pipeline_set_auto_flush_bus( GST_PIPELINE(pipeline_), true);
 
+    // native YUV frames are converted to RGB on GPU (not for images, and not
+    // for cached frames which are kept in RGBA textures after first display)
+    // NB: I420 is the native output of most software decoders, and
+    // videoconvert then only has to pass it through (or re-pack NV12)
+    yuv_ = Settings::application.render.native_yuv && !media_.isimage && !cache_enabled_;
+
     // GstCaps *caps = gst_static_caps_get (&frame_render_caps);    
-    string capstring = "video/x-raw,format=RGBA,width="+ std::to_string(media_.width) +
-            ",height=" + std::to_string(media_.height);
+    string capstring = "video/x-raw,format=" + string(yuv_ ? "I420" : "RGBA");
     GstCaps *caps = gst_caps_from_string(capstring.c_str());
-    if (!gst_video_info_from_caps (&v_frame_video_info_, caps)) {
+    capstring += ",width="+ std::to_string(decode_width_) + ",height=" + std::to_string(decode_height_);
+    GstCaps *framecaps = gst_caps_from_string(capstring.c_str());
+    bool valid = gst_video_info_from_caps (&v_frame_video_info_, framecaps);
+    gst_caps_unref (framecaps);
+    if (!valid) {
         Log::Warning("MediaPlayer %s Could not configure video frame info", std::to_string(id_).c_str());
         failed_ = true;
         return;
     }
+    // frames received by the appsink have this layout until caps change
+    sink_video_info_ = v_frame_video_info_;
+    gst_caps_replace(&sink_caps_, NULL);
+
+    // scale frames to the decode resolution
+    if (!media_.isimage)
+        set_decode_size(decode_width_, decode_height_);
+
+    // create RAM cache of frames (frame layout is known)
+    if ( cache_enabled_ && cache_ == nullptr && isCacheable() )
+        cache_ = new FrameCache( GST_VIDEO_INFO_SIZE(&v_frame_video_info_) );
+    cache_last_pts_ = GST_CLOCK_TIME_NONE;
+    cache_loops_ = 0;
 
     // setup uridecodebin
     if (force_software_decoding_) {
         g_object_set (G_OBJECT (gst_bin_get_by_name (GST_BIN (pipeline_), "decoder")), "force-sw-decoders", true,  NULL);
     }
 
+    // share the decoding threads with other pipelines
+    DecoderThreads::setup(pipeline_, load_priority_);
+
+    // feed uridecodebin with the copy of the file in RAM
+    if (memory_reading_) {
+        GstElement *decoder = gst_bin_get_by_name (GST_BIN (pipeline_), "decoder");
+        g_signal_connect (G_OBJECT (decoder), "source-setup", G_CALLBACK (MediaMemory::setup_source), memory_.get());
+        gst_object_unref (decoder);
+    }
+
     // setup appsink
     GstElement *sink = gst_bin_get_by_name (GST_BIN (pipeline_), "sink");
     if (!sink) {
@@ -386,8 +1053,11 @@ void MediaPlayer::execute_open()
     Rendering::LinkPipeline(GST_PIPELINE (pipeline_));
 #endif
 
-    // set to desired state (PLAY or PAUSE)
-    GstStateChangeReturn ret = gst_element_set_state (pipeline_, desired_state_);
+    // set to desired state (PLAY or PAUSE), paused if disabled
+    // (seekable media pre-roll paused: update() seeks to set up the first
+    // segment before playing, so that the flush is not visible)
+    starting_ = media_.seekable;
+    GstStateChangeReturn ret = gst_element_set_state (pipeline_, enabled_ && !starting_ ? desired_state_ : GST_STATE_PAUSED);
     if (ret == GST_STATE_CHANGE_FAILURE) {
         Log::Warning("MediaPlayer %s Could not open '%s'", std::to_string(id_).c_str(), uri_.c_str());
         failed_ = true;
@@ -414,6 +1084,97 @@ void MediaPlayer::execute_open()
     MediaPlayer::registered_.push_back(this);
 }
 
+void MediaPlayer::execute_open_image()
+{
+    yuv_ = false;
+    upload_image(image_loading_level_);
+
+    Log::Info("MediaPlayer %s Opened '%s' (%s %d x %d)", std::to_string(id_).c_str(),
+              uri_.c_str(), media_.codec_name.c_str(), media_.width, media_.height);
+
+    opened_ = true;
+
+    // register media player
+    MediaPlayer::registered_.push_back(this);
+}
+
+guint MediaPlayer::maxImageSize()
+{
+    return max_image_size_ > 0 ? max_image_size_.load() : MEDIA_IMAGE_MAX_SIZE;
+}
+
+guint MediaPlayer::image_min_level() const
+{
+    return image_level(media_.width, media_.height, image_memory_ - image_bytes_);
+}
+
+void MediaPlayer::update_image()
+{
+    // level decoded in background: replace texture
+    if ( image_loading_.valid() ) {
+        if ( image_loading_.wait_for( std::chrono::milliseconds(0) ) == std::future_status::ready ) {
+            if ( image_loading_.get() )
+                upload_image(image_loading_level_);
+            image_loading_ = std::future<bool>();
+        }
+        return;
+    }
+
+    // level needed for display, in the limits of texture size and memory
+    guint level = adapt_decode_level( image_min_level(), MEDIA_IMAGE_MAX_LEVEL );
+    if ( level != decode_level_ ) {
+        guint64 others = image_memory_ - image_bytes_;
+        image_loading_ = discoverer_pool().submit<bool>( [this, level, others]() {
+            guint w = 0, h = 0;
+            return decode_still_image(uri_, level, others, &image_, &w, &h, &image_loading_level_);
+        }, load_priority_);
+    }
+}
+
+void MediaPlayer::upload_image(guint level)
+{
+    // replace texture
+    release_texture();
+
+    // OpenGL limit of texture size
+    if (max_image_size_ == 0) {
+        GLint max = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max);
+        max_image_size_ = MAX(max, 1);
+    }
+
+    decode_level_ = level;
+    decode_width_  = MAX( 1u, media_.width  >> level );
+    decode_height_ = MAX( 1u, media_.height >> level );
+
+    // all levels of detail, for display much smaller than the image
+    GLsizei levels = 1;
+    for (guint s = MAX(decode_width_, decode_height_); s > 1; s >>= 1)
+        ++levels;
+
+    glActiveTexture(GL_TEXTURE0);
+    glGenTextures(1, &textureindex_);
+    glBindTexture(GL_TEXTURE_2D, textureindex_);
+    glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGBA8, decode_width_, decode_height_);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, decode_width_, decode_height_,
+                    GL_RGBA, GL_UNSIGNED_BYTE, image_.data());
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // pixels are in GPU memory only
+    std::vector<guint8>().swap(image_);
+    image_bytes_ = (guint64) decode_width_ * decode_height_ * 16 / 3;
+    image_memory_ += image_bytes_;
+
+#ifdef MEDIA_PLAYER_DEBUG
+    Log::Info("MediaPlayer %s Image texture %d x %d", std::to_string(id_).c_str(), decode_width_, decode_height_);
+#endif
+}
+
 bool MediaPlayer::isOpen() const
 {
     return opened_;
@@ -429,21 +1190,64 @@ void MediaPlayer::Frame::unmap()
     if ( full )
         gst_video_frame_unmap(&vframe);
     full = false;
+
+    // give back the upload slot if not consumed
+    if ( ring && slot > -1 )
+        ring->release(slot);
+    slot = -1;
 }
 
 void MediaPlayer::close()
 {
+    // finish decoding image (if started)
+    if (image_loading_.valid()) {
+        image_loading_.wait();
+        image_loading_ = std::future<bool>();
+        std::vector<guint8>().swap(image_);
+    }
+
+    // forget index (if not done)
+    if (keyframes_.valid()) {
+        index_pool().cancel(index_priority_);
+        keyframes_ = std::future< std::vector<GstClockTime> >();
+    }
+
+    // reloading: wait for the pipeline to be stopped, and clean up
+    if (stopping_.valid()) {
+        stopping_.wait();
+        stopping_ = std::future<bool>();
+        opened_ = true;
+    }
+
     // not openned?
     if (!opened_) {
-        // wait for loading to finish
-        if (discoverer_.valid())
+        // cancel loading if not started, or wait for it to finish
+        if (discoverer_.valid()) {
+            discoverer_pool().cancel(load_priority_);
             discoverer_.wait();
+            discoverer_ = std::future<MediaInfo>();
+        }
+        // free image decoded meanwhile
+        std::vector<guint8>().swap(image_);
         // nothing else to change
         return;
     }
 
+    // stop sharing decoding
+    if (leader_) {
+        leader_->followers_.remove(this);
+        leader_ = nullptr;
+    }
+    else
+        diverge();
+
     // un-ready the media player
     opened_ = false;
+    sync_group_ = GST_CLOCK_TIME_NONE;
+    if ( sync_requested_ ) {
+        sync_waiting_.remove(this);
+        sync_requested_ = false;
+    }
 
     // clean up GST
     if (pipeline_ != nullptr) {
@@ -463,14 +1267,35 @@ void MediaPlayer::close()
     }
 
     // cleanup eventual remaining frame memory
-    for(guint i = 0; i < N_VFRAME; i++) {
-        frame_[i].access.lock();
+    for(guint i = 0; i < N_VFRAME; i++)
         frame_[i].unmap();
-        frame_[i].access.unlock();
+    gst_caps_replace(&sink_caps_, NULL);
+
+    // free upload rings of previous decode levels (not used anymore,
+    // nor by a frame pending in the uploader)
+    uploader_.reset();
+    for (auto r = retired_rings_.begin(); r != retired_rings_.end(); ++r)
+        delete *r;
+    retired_rings_.clear();
+    frame_queue_.reset();
+
+    // free RAM cache (no more frames coming)
+    cached_ = false;
+    release_frame_textures();
+    if (cache_) {
+        delete cache_.load();
+        cache_ = nullptr;
     }
-    write_index_ = 0;
-    last_index_ = 0;
 
+    // not reading anymore
+    memory_reading_ = false;
+
+    // end reverse decoding
+    reversed_ = false;
+    if (reverse_) {
+        delete reverse_;
+        reverse_ = nullptr;
+    }
 
 #ifdef MEDIA_PLAYER_DEBUG
     Log::Info("MediaPlayer %s closed", std::to_string(id_).c_str());
@@ -481,23 +1306,83 @@ void MediaPlayer::close()
 }
 
 
-guint MediaPlayer::width() const
+void MediaPlayer::suspend()
 {
-    return media_.width;
-}
+    if ( !opened_ || suspended_ )
+        return;
 
-guint MediaPlayer::height() const
-{
-    return media_.height;
+    // remember where to continue (position of leader if shared)
+    resume_position_ = position();
+
+    // keep indexing keyframes meanwhile
+    std::future< std::vector<GstClockTime> > keyframes = std::move(keyframes_);
+
+    // terminate pipeline
+    close();
+    keyframes_ = std::move(keyframes);
+
+    // free GPU memory
+    release_texture();
+    if (pbo_ring_) {
+        delete pbo_ring_.load();
+        pbo_ring_ = nullptr;
+    }
+
+    suspended_ = true;
 }
 
-float MediaPlayer::aspectRatio() const
+void MediaPlayer::resume()
+{
+    if ( !suspended_ )
+        return;
+
+    suspended_ = false;
+
+    // decode still image again
+    if ( still_image_file(uri_) ) {
+        discoverer_ = discoverer_pool().submit<MediaInfo>( std::bind(image_decoder, uri_, &image_, &image_loading_level_), load_priority_);
+        return;
+    }
+
+    // re-create own pipeline (does not share decoding
+    // because the position is not the same as others)
+    execute_open();
+}
+
+guint MediaPlayer::width() const
+{
+    return media_.width;
+}
+
+guint MediaPlayer::height() const
+{
+    return media_.height;
+}
+
+guint MediaPlayer::decodeWidth() const
+{
+    if (leader_)
+        return leader_->decodeWidth();
+    return decode_width_ > 0 ? decode_width_ : media_.width;
+}
+
+guint MediaPlayer::decodeHeight() const
+{
+    if (leader_)
+        return leader_->decodeHeight();
+    return decode_height_ > 0 ? decode_height_ : media_.height;
+}
+
+float MediaPlayer::aspectRatio() const
 {
     return static_cast<float>(media_.par_width) / static_cast<float>(media_.height);
 }
 
 GstClockTime MediaPlayer::position()
 {
+    if (leader_)
+        return leader_->position();
+
     if (position_ == GST_CLOCK_TIME_NONE && pipeline_ != nullptr) {
         gint64 p = GST_CLOCK_TIME_NONE;
         if ( gst_element_query_position (pipeline_, GST_FORMAT_TIME, &p) )
@@ -509,18 +1394,31 @@ GstClockTime MediaPlayer::position()
 
 void MediaPlayer::enable(bool on)
 {
-    if ( !opened_ || pipeline_ == nullptr)
+    if ( !opened_ )
+        return;
+
+    // follower has no pipeline to change
+    if ( leader_ ) {
+        enabled_ = on;
+        return;
+    }
+
+    if ( pipeline_ == nullptr )
         return;
 
     if ( enabled_ != on ) {
 
+        // followers shall keep on playing without the leader
+        if (!on)
+            diverge();
+
         enabled_ = on;
 
         // default to pause
         GstState requested_state = GST_STATE_PAUSED;
 
-        // unpause only if enabled
-        if (enabled_) {
+        // unpause only if enabled (and not playing from cache or reverse decoder)
+        if (enabled_ && !cached_ && !reversed_) {
             requested_state = desired_state_;
         }
 
@@ -546,10 +1444,14 @@ bool MediaPlayer::isImage() const
 
 std::string MediaPlayer::decoderName()
 {
+    if (leader_)
+        return leader_->decoderName();
+
     // decoder_name_ not initialized
     if (decoder_name_.empty()) {
         // try to know if it is a hardware decoder
-        decoder_name_ = GstToolkit::used_gpu_decoding_plugins(pipeline_);
+        if (pipeline_ != nullptr)
+            decoder_name_ = GstToolkit::used_gpu_decoding_plugins(pipeline_);
         // nope, then it is a sofware decoder
         if (decoder_name_.empty())
             decoder_name_ = "software";
@@ -571,9 +1473,15 @@ void MediaPlayer::setSoftwareDecodingForced(bool on)
     force_software_decoding_ = on;
     decoder_name_ = "";
 
-    // changing state requires reload
-    if (need_reload)
-        reopen();
+    // changing state requires reload (of own pipeline)
+    if (need_reload) {
+        if (leader_)
+            split();
+        else {
+            diverge();
+            reopen();
+        }
+    }
 }
 
 void MediaPlayer::play(bool on)
@@ -589,8 +1497,104 @@ void MediaPlayer::play(bool on)
     if (desired_state_ == requested_state)
         return;
 
+    // change of playback state
+    diverge();
+
+    // apply
+    execute_play_command(on);
+}
+
+// delay to set all pipelines to PLAYING before start
+#define SYNC_START_DELAY (40 * GST_MSECOND)
+// maximum time to wait for pre-roll
+#define SYNC_PREROLL_TIMEOUT (500 * GST_MSECOND)
+
+void MediaPlayer::playSynchronized(const std::list<MediaPlayer*> &players)
+{
+    std::list<MediaPlayer*> group;
+    for (auto it = players.begin(); it != players.end(); ++it) {
+        MediaPlayer *mp = *it;
+        if ( !mp->isOpen() || !mp->enabled_ || mp->media_.isimage )
+            continue;
+        // synchronize requires its own pipeline
+        mp->diverge();
+        if ( mp->pipeline_ == nullptr )
+            continue;
+        // pause and rewind if stopped at end of stream
+        mp->execute_play_command(false);
+        if ( ( mp->rate_ < 0.0 && mp->position_ <= mp->timeline_.next(0) )
+             || ( mp->rate_ > 0.0 && mp->position_ >= mp->timeline_.previous(mp->timeline_.last()) ) )
+            mp->rewind();
+        group.push_back(mp);
+    }
+
+    if (group.empty())
+        return;
+
+    // wait for all to be pre-rolled (in update of each; bounded delay)
+    // NB: players of a previous request not started yet join this one
+    for (auto it = group.begin(); it != group.end(); ++it) {
+        MediaPlayer *mp = *it;
+        mp->sync_prerolled_ = false;
+        if ( !mp->sync_requested_ ) {
+            mp->sync_requested_ = true;
+            sync_waiting_.push_back(mp);
+        }
+    }
+    sync_timeout_ = gst_util_get_timestamp() + SYNC_PREROLL_TIMEOUT;
+}
+
+void MediaPlayer::start_synchronized()
+{
+    // all pre-rolled, or waited long enough
+    bool ready = true;
+    for (auto it = sync_waiting_.begin(); ready && it != sync_waiting_.end(); ++it)
+        ready = (*it)->sync_prerolled_;
+    if ( !ready && gst_util_get_timestamp() < sync_timeout_ )
+        return;
+
+    std::list<MediaPlayer*> group;
+    group.swap(sync_waiting_);
+    for (auto it = group.begin(); it != group.end(); ++it)
+        (*it)->sync_requested_ = false;
+
+    // one clock for all, and same start time
+    GstClock *clock = gst_system_clock_obtain();
+    GstClockTime start = gst_clock_get_time(clock) + SYNC_START_DELAY;
+
+    for (auto it = group.begin(); it != group.end(); ++it) {
+        MediaPlayer *mp = *it;
+        if ( !mp->cached_ && mp->pipeline_ != nullptr ) {
+            gst_pipeline_use_clock(GST_PIPELINE(mp->pipeline_), clock);
+            // running time reached when paused continues at start time
+            GstClockTime running = gst_element_get_start_time(mp->pipeline_);
+            if ( !GST_CLOCK_TIME_IS_VALID(running) || running > start )
+                running = 0;
+            // fix base time (pipeline does not compute it if no start time)
+            gst_element_set_start_time(mp->pipeline_, GST_CLOCK_TIME_NONE);
+            gst_element_set_base_time(mp->pipeline_, start - running);
+            mp->sync_base_ = start - running;
+        }
+        mp->execute_play_command(true);
+        mp->sync_offset_ = 0;
+        mp->sync_group_ = start;
+    }
+
+    gst_object_unref(clock);
+
+#ifdef MEDIA_PLAYER_DEBUG
+    Log::Info("MediaPlayer synchronized play of %d media", (int) group.size());
+#endif
+}
+
+void MediaPlayer::execute_play_command(bool on)
+{
     // accept request to the desired state
-    desired_state_ = requested_state;
+    desired_state_ = on ? GST_STATE_PLAYING : GST_STATE_PAUSED;
+
+    // pause ends synchronized play
+    if (!on)
+        sync_group_ = GST_CLOCK_TIME_NONE;
 
     // if not ready yet, the requested state will be handled later
     if ( pipeline_ == nullptr )
@@ -603,6 +1607,10 @@ void MediaPlayer::play(bool on)
             rewind();
     }
 
+    // playing from cache or reverse decoder: pipeline stays paused
+    if (cached_ || reversed_)
+        return;
+
     // all ready, apply state change immediately
     GstStateChangeReturn ret = gst_element_set_state (pipeline_, desired_state_);
     if (ret == GST_STATE_CHANGE_FAILURE) {
@@ -624,6 +1632,14 @@ bool MediaPlayer::isPlaying(bool testpipeline) const
     if (media_.isimage)
         return false;
 
+    // shared decoding: state of the leader
+    if (leader_)
+        return leader_->isPlaying(testpipeline);
+
+    // playing from cache or reverse decoder: pipeline is paused
+    if (cached_ || reversed_)
+        return desired_state_ == GST_STATE_PLAYING;
+
     // if not ready yet, answer with requested state
     if ( !testpipeline || pipeline_ == nullptr || !enabled_)
         return desired_state_ == GST_STATE_PLAYING;
@@ -642,6 +1658,9 @@ MediaPlayer::LoopMode MediaPlayer::loop() const
     
 void MediaPlayer::setLoop(MediaPlayer::LoopMode mode)
 {
+    if (loop_ != mode)
+        diverge();
+
     loop_ = mode;
 }
 
@@ -650,6 +1669,9 @@ void MediaPlayer::rewind()
     if (!enabled_ || !media_.seekable)
         return;
 
+    // change of playback state
+    diverge();
+
     // playing forward, loop to begin
     if (rate_ > 0.0) {
         // begin is the end of a gab which includes the first PTS (if exists)
@@ -671,15 +1693,27 @@ void MediaPlayer::step()
     if (!enabled_ || isPlaying())
         return;
 
+    // change of playback state
+    diverge();
+
     if ( ( rate_ < 0.0 && position_ <= timeline_.next(0)  )
          || ( rate_ > 0.0 && position_ >= timeline_.previous(timeline_.last()) ) )
         rewind();
 
+    // step in cache or reverse decoder
+    if (cached_ || reversed_) {
+        if (rate_ > 0.0)
+            execute_seek_command( position_ + timeline_.step() );
+        else if (position_ > timeline_.step())
+            execute_seek_command( position_ - timeline_.step() );
+        return;
+    }
+
     // step 
     gst_element_send_event (pipeline_, gst_event_new_step (GST_FORMAT_BUFFERS, 1, ABS(rate_), TRUE,  FALSE));
 }
 
-bool MediaPlayer::go_to(GstClockTime pos)
+bool MediaPlayer::go_to(GstClockTime pos, bool snap)
 {
     bool ret = false;
     TimeInterval gap;
@@ -697,19 +1731,25 @@ bool MediaPlayer::go_to(GstClockTime pos)
 
         if (ABS_DIFF (position_, jumpPts) > 2 * timeline_.step() ) {
             ret = true;
-            seek( jumpPts );
+            seek( jumpPts, snap );
         }
     }
     return ret;
 }
 
-void MediaPlayer::seek(GstClockTime pos)
+void MediaPlayer::seek(GstClockTime pos, bool snap)
 {
     if (!enabled_ || !media_.seekable || seeking_)
         return;
 
+    // change of playback state
+    diverge();
+
     // apply seek
     GstClockTime target = CLAMP(pos, timeline_.begin(), timeline_.end());
+    // cheapest nearby position : a keyframe
+    if (snap)
+        target = timeline_.keyframeNear(target, MEDIA_SEEK_SNAP);
     execute_seek_command(target);
 
 }
@@ -719,17 +1759,36 @@ void MediaPlayer::jump()
     if (!enabled_ || !isPlaying())
         return;
 
+    // change of playback state
+    diverge();
+
+    // jump in cache or reverse decoder
+    if (cached_ || reversed_) {
+        GstClockTime d = 30 * timeline_.step();
+        execute_seek_command( rate_ > 0.0 ? position_ + d : (position_ > d ? position_ - d : 0) );
+        return;
+    }
+
     gst_element_send_event (pipeline_, gst_event_new_step (GST_FORMAT_BUFFERS, 1, 30.f * ABS(rate_), TRUE,  FALSE));
 }
 
 void MediaPlayer::init_texture(guint index)
 {
+    // YUV frames are uploaded as planes
+    if (yuv_) {
+        init_planes();
+        return;
+    }
+
     glActiveTexture(GL_TEXTURE0);
     glGenTextures(1, &textureindex_);
     glBindTexture(GL_TEXTURE_2D, textureindex_);
-    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, media_.width, media_.height);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, media_.width, media_.height,
-                    GL_RGBA, GL_UNSIGNED_BYTE, frame_[index].vframe.data[0]);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, decode_width_, decode_height_);
+
+    // a still image is uploaded once (no need for pixel buffers)
+    if (media_.isimage)
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, decode_width_, decode_height_,
+                        GL_RGBA, GL_UNSIGNED_BYTE, frame_[index].vframe.data[0]);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -737,46 +1796,21 @@ void MediaPlayer::init_texture(guint index)
 
     if (!media_.isimage) {
 
-        // set pbo image size
-        pbo_size_ = media_.height * media_.width * 4;
-
-        // create pixel buffer objects,
-        if (pbo_[0])
-            glDeleteBuffers(2, pbo_);
-        glGenBuffers(2, pbo_);
-
-        for(int i = 0; i < 2; i++ ) {
-            // create 2 PBOs
-            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_[i]);
-            // glBufferDataARB with NULL pointer reserves only memory space.
-            glBufferData(GL_PIXEL_UNPACK_BUFFER, pbo_size_, 0, GL_STREAM_DRAW);
-            // fill in with reset picture
-            GLubyte* ptr = (GLubyte*) glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
-            if (ptr)  {
-                // update data directly on the mapped buffer
-                memmove(ptr, frame_[index].vframe.data[0], pbo_size_);
-                // release pointer to mapping buffer
-                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-            }
-            else {
-                // did not work, disable PBO
-                glDeleteBuffers(2, pbo_);
-                pbo_[0] = pbo_[1] = 0;
-                pbo_size_ = 0;
-                break;
+        // prefer a ring of persistently mapped PBO, written directly by fill_frame()
+        if ( pbo_ring_ == nullptr && PixelBufferRing::supported() ) {
+            PixelBufferRing *ring = new PixelBufferRing(decode_height_ * decode_width_ * 4, N_VFRAME + 2);
+            if (ring->valid()) {
+                pbo_ring_ = ring;
+#ifdef MEDIA_PLAYER_DEBUG
+                Log::Info("MediaPlayer %s uses OpenGL persistent PBO ring texturing.", std::to_string(id_).c_str());
+#endif
+                glBindTexture(GL_TEXTURE_2D, 0);
+                return;
             }
-
+            delete ring;
         }
 
-        // should be good to go, wrap it up
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-        pbo_index_ = 0;
-        pbo_next_index_ = 1;
-
-//        // now that a frame is ready, and once only, browse into the pipeline
-//        // for possible hadrware decoding plugins used. Empty string means none.
-//        hardware_decoder_ = GstToolkit::used_gpu_decoding_plugins(pipeline_);
-
+        // otherwise frames are copied in the PBO of the texture uploader
 #ifdef MEDIA_PLAYER_DEBUG
         Log::Info("MediaPlayer %s uses OpenGL PBO texturing.", std::to_string(id_).c_str());
 #endif
@@ -786,51 +1820,331 @@ void MediaPlayer::init_texture(guint index)
 }
 
 
+void MediaPlayer::release_texture()
+{
+    // cleanup opengl texture
+    if (textureindex_)
+        glDeleteTextures(1, &textureindex_);
+    textureindex_ = 0;
+
+    // texture of image is freed
+    image_memory_ -= image_bytes_;
+    image_bytes_ = 0;
+
+    // cleanup picture buffer (and pending upload)
+    uploader_.reset();
+    uploader_.setCallback(nullptr);
+
+    // cleanup YUV planes and conversion
+    if (yuv_textures_[0])
+        glDeleteTextures(2, yuv_textures_);
+    yuv_textures_[0] = yuv_textures_[1] = 0;
+    if (yuv_surface_)
+        delete yuv_surface_;
+    yuv_surface_ = nullptr;
+    if (yuv_buffer_)
+        delete yuv_buffer_;
+    yuv_buffer_ = nullptr;
+}
+
 void MediaPlayer::fill_texture(guint index)
 {
+    // first frame decoded at another resolution (decode level changed):
+    // adopt its layout, and re-create the texture at its size
+    const GstVideoInfo *info = &frame_[index].info;
+    if ( GST_VIDEO_INFO_WIDTH(info) > 0 &&
+         ( GST_VIDEO_INFO_WIDTH(info)  != GST_VIDEO_INFO_WIDTH(&v_frame_video_info_) ||
+           GST_VIDEO_INFO_HEIGHT(info) != GST_VIDEO_INFO_HEIGHT(&v_frame_video_info_) ) )
+    {
+        v_frame_video_info_ = *info;
+        decode_width_  = GST_VIDEO_INFO_WIDTH(info);
+        decode_height_ = GST_VIDEO_INFO_HEIGHT(info);
+        // the upload ring has the size of frames: a new one is created with the
+        // texture (the streaming thread may still use the previous one until close)
+        if (pbo_ring_) {
+            retired_rings_.push_back(pbo_ring_.load());
+            pbo_ring_ = nullptr;
+        }
+        release_texture();
+    }
+
     // is this the first frame ?
     if (textureindex_ < 1)
     {
-        // initialize texture
+        // initialize texture (a still image is filled at once)
         init_texture(index);
+        if (media_.isimage)
+            return;
     }
-    else {
-        glBindTexture(GL_TEXTURE_2D, textureindex_);
-
-        // use dual Pixel Buffer Object
-        if (pbo_size_ > 0) {
-            // In dual PBO mode, increment current index first then get the next index
-            pbo_index_ = (pbo_index_ + 1) % 2;
-            pbo_next_index_ = (pbo_index_ + 1) % 2;
-
-            // bind PBO to read pixels
-            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_[pbo_index_]);
-            // copy pixels from PBO to texture object
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, media_.width, media_.height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
-            // bind the next PBO to write pixels
-            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_[pbo_next_index_]);
-            // See http://www.songho.ca/opengl/gl_pbo.html#map for more details
-            glBufferData(GL_PIXEL_UNPACK_BUFFER, pbo_size_, 0, GL_STREAM_DRAW);
-            // map the buffer object into client's memory
-            GLubyte* ptr = (GLubyte*) glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
-            if (ptr) {
-                // update data directly on the mapped buffer
-                // NB : equivalent but faster (memmove instead of memcpy ?) than
-                // glNamedBufferSubData(pboIds[nextIndex], 0, imgsize, vp->getBuffer())
-                memmove(ptr, frame_[index].vframe.data[0], pbo_size_);
-
-                // release pointer to mapping buffer
-                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-            }
-            // done with PBO
-            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // upload through the texture uploader (batched after update of all sources)
+    TextureUploader::Plane planes[TEXTUREUPLOADER_PLANES];
+    if (frame_[index].slot > -1) {
+        // frame already in the persistent PBO ring: upload from offset of planes
+        // (the mapping is write-only, never read it from client side)
+        uploader_.submit(frame_[index].ring, frame_[index].slot, planes, frame_planes(planes));
+        // slot is now owned by the uploader until transfer is issued
+        frame_[index].slot = -1;
+    }
+    else
+        uploader_.submit(planes, frame_planes(planes, &frame_[index].vframe));
+}
+
+guint MediaPlayer::frame_planes(TextureUploader::Plane *planes, const GstVideoFrame *frame, const guint8 *data) const
+{
+    // RGBA frame in one texture, or YUV planes (textureindex_ is Y plane)
+    guint n = yuv_ ? 3 : 1;
+    for (guint p = 0; p < n; ++p) {
+        planes[p].texture = p > 0 ? yuv_textures_[p-1] : textureindex_;
+        planes[p].width   = GST_VIDEO_INFO_COMP_WIDTH(&v_frame_video_info_, p);
+        planes[p].height  = GST_VIDEO_INFO_COMP_HEIGHT(&v_frame_video_info_, p);
+        planes[p].format  = yuv_ ? GL_RED : GL_RGBA;
+        // pixels of the mapped gst frame
+        if (frame) {
+            planes[p].stride = GST_VIDEO_FRAME_PLANE_STRIDE(frame, p);
+            planes[p].data   = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA(frame, p);
+            planes[p].offset = 0;
         }
+        // otherwise in the layout of frames (slot of ring or cached frame)
         else {
-            // without PBO, use standard opengl (slower)
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, media_.width, media_.height,
-                            GL_RGBA, GL_UNSIGNED_BYTE, frame_[index].vframe.data[0]);
+            planes[p].stride = GST_VIDEO_INFO_PLANE_STRIDE(&v_frame_video_info_, p);
+            planes[p].offset = GST_VIDEO_INFO_PLANE_OFFSET(&v_frame_video_info_, p);
+            planes[p].data   = data ? data + planes[p].offset : nullptr;
         }
+    }
+    return n;
+}
+
+void MediaPlayer::init_planes()
+{
+    // create one texture per plane: full size Y, subsampled U and V
+    glActiveTexture(GL_TEXTURE0);
+    glGenTextures(1, &textureindex_);
+    glGenTextures(2, yuv_textures_);
+    for (guint p = 0; p < 3; ++p) {
+        glBindTexture(GL_TEXTURE_2D, p > 0 ? yuv_textures_[p-1] : textureindex_);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, GST_VIDEO_INFO_COMP_WIDTH(&v_frame_video_info_, p),
+                       GST_VIDEO_INFO_COMP_HEIGHT(&v_frame_video_info_, p));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // get color matrix and range actually negotiated with the decoder
+    YUVShader *shader = new YUVShader;
+    GstElement *sink = gst_bin_get_by_name (GST_BIN (pipeline_), "sink");
+    if (sink) {
+        GstPad *pad = gst_element_get_static_pad (sink, "sink");
+        GstCaps *caps = pad ? gst_pad_get_current_caps (pad) : NULL;
+        GstVideoInfo info;
+        if (caps && gst_video_info_from_caps (&info, caps)) {
+            gdouble Kr = 0.0, Kb = 0.0;
+            if ( gst_video_color_matrix_get_Kr_Kb (info.colorimetry.matrix, &Kr, &Kb) )
+                shader->coefficients = glm::vec2(Kr, Kb);
+            shader->fullrange = info.colorimetry.range == GST_VIDEO_COLOR_RANGE_0_255;
+        }
+        if (caps)
+            gst_caps_unref (caps);
+        if (pad)
+            gst_object_unref (pad);
+        gst_object_unref (sink);
+    }
+
+    // surface drawing the planes converted to RGB into the frame buffer
+    shader->u_texture = yuv_textures_[0];
+    shader->v_texture = yuv_textures_[1];
+    yuv_surface_ = new Surface(shader);
+    yuv_surface_->setTextureIndex(textureindex_);
+    yuv_buffer_ = new FrameBuffer(decode_width_, decode_height_);
+
+    // ring of persistently mapped PBO, written directly by fill_frame()
+    if ( pbo_ring_ == nullptr && PixelBufferRing::supported() ) {
+        PixelBufferRing *ring = new PixelBufferRing(GST_VIDEO_INFO_SIZE(&v_frame_video_info_), N_VFRAME + 2);
+        if (ring->valid())
+            pbo_ring_ = ring;
+        else
+            delete ring;
+    }
+
+#ifdef MEDIA_PLAYER_DEBUG
+    Log::Info("MediaPlayer %s uses OpenGL YUV texturing%s.", std::to_string(id_).c_str(),
+              pbo_ring_ ? " with persistent PBO ring" : "");
+#endif
+
+    // planes are converted to RGB each time they are uploaded
+    uploader_.setCallback( std::bind(&MediaPlayer::convert_planes, this) );
+}
+
+void MediaPlayer::convert_planes()
+{
+    // convert to RGB
+    yuv_buffer_->begin(false);
+    yuv_surface_->draw(glm::identity<glm::mat4>(), yuv_buffer_->projection());
+    yuv_buffer_->end();
+}
+
+void MediaPlayer::fill_cached(const guint8 *data)
+{
+    if (textureindex_ < 1)
+        return;
+
+    displaycount_.tic();
+
+    // cached frames have the layout of v_frame_video_info_
+    TextureUploader::Plane planes[TEXTUREUPLOADER_PLANES];
+    uploader_.submit(planes, frame_planes(planes, nullptr, data));
+}
+
+void MediaPlayer::update_cached()
+{
+    guint64 now = gst_util_get_timestamp();
+
+    // entering cache mode: no need to decode anymore
+    if (!cached_) {
+        cached_ = true;
+        cached_pts_ = GST_CLOCK_TIME_NONE;
+        cached_time_ = now;
+        gst_element_set_state (pipeline_, GST_STATE_PAUSED);
+#ifdef MEDIA_PLAYER_DEBUG
+        Log::Info("MediaPlayer %s Plays from RAM cache", std::to_string(id_).c_str());
+#endif
+    }
+
+    advance_position(now);
+
+    // display frame at position (if changed)
+    if ( position_ != GST_CLOCK_TIME_NONE && ( cached_pts_ == GST_CLOCK_TIME_NONE ||
+         position_ < cached_pts_ || position_ >= cached_pts_ + timeline_.step() ) ) {
+        FrameCache *cache = cache_;
+        GstClockTime pts = GST_CLOCK_TIME_NONE;
+        FrameCache::FrameData frame = cache->lookup(position_, timeline_.step(), &pts);
+        if (frame) {
+            show_cached(pts, frame->data());
+            cached_pts_ = pts;
+            timecount_.tic();
+        }
+        // hole in cache (e.g. timeline changed): decode again
+        else
+            cache->validate(timeline_);
+    }
+}
+
+void MediaPlayer::show_cached(GstClockTime pts, const guint8 *data)
+{
+    // frame uploaded in its texture at first display (RGBA only)
+    auto t = frame_textures_.find(pts);
+    if ( t == frame_textures_.end() && !yuv_ &&
+         frame_textures_.size() * decode_width_ * decode_height_ * 4 < MEDIA_FRAME_TEXTURES_MEMORY ) {
+        guint tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, decode_width_, decode_height_);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, decode_width_, decode_height_,
+                        GL_RGBA, GL_UNSIGNED_BYTE, data);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glBindTexture(GL_TEXTURE_2D, 0);
+        t = frame_textures_.emplace(pts, tex).first;
+    }
+
+    // next loops: only change the texture displayed
+    if ( t != frame_textures_.end() ) {
+        frame_texture_ = t->second;
+        displaycount_.tic();
+    }
+    // otherwise upload in the texture of the player
+    else {
+        frame_texture_ = 0;
+        fill_cached(data);
+    }
+}
+
+void MediaPlayer::release_frame_textures()
+{
+    for (auto t = frame_textures_.begin(); t != frame_textures_.end(); ++t)
+        glDeleteTextures(1, &t->second);
+    frame_textures_.clear();
+    frame_texture_ = 0;
+}
+
+void MediaPlayer::advance_position(guint64 now)
+{
+    // extremities of the timeline (not in a gap)
+    GstClockTime begin = timeline_.next(0);
+    GstClockTime end = timeline_.previous(timeline_.last());
+
+    // advance in time, like the pipeline clock would
+    if ( enabled_ && desired_state_ == GST_STATE_PLAYING ) {
+        gint64 pos = position_ == GST_CLOCK_TIME_NONE ? begin : position_;
+        pos += (gint64) ( (gdouble) (now - cached_time_) * rate_ );
+
+        // jump over gaps
+        TimeInterval gap;
+        if ( pos > 0 && timeline_.getGapAt( (GstClockTime) pos, gap) && gap.is_valid() )
+            pos = rate_ > 0.0 ? gap.end : gap.begin;
+
+        // reached an extremity: loop
+        if ( pos > (gint64) end || pos < (gint64) begin ) {
+            if (loop_ == LOOP_REWIND)
+                pos = rate_ > 0.0 ? begin : end;
+            else if (loop_ == LOOP_BIDIRECTIONAL) {
+                pos = rate_ > 0.0 ? end : begin;
+                rate_ *= - 1.f;
+            }
+            else { //LOOP_NONE
+                pos = rate_ > 0.0 ? end : begin;
+                desired_state_ = GST_STATE_PAUSED;
+            }
+        }
+        position_ = pos;
+    }
+    cached_time_ = now;
+}
+
+bool MediaPlayer::use_reverse_decoder() const
+{
+    // backward in a media indexed by keyframes (unless reverse decoder failed)
+    return rate_ < 0.0 && media_.seekable && !media_.isimage && timeline_.hasKeyframes()
+            && !( reverse_ != nullptr && reverse_->failed() );
+}
+
+void MediaPlayer::update_reversed()
+{
+    guint64 now = gst_util_get_timestamp();
+
+    // entering reverse mode: pipeline does not decode anymore
+    if (!reversed_) {
+        reversed_ = true;
+        cached_pts_ = GST_CLOCK_TIME_NONE;
+        cached_time_ = now;
+        gst_element_set_state (pipeline_, GST_STATE_PAUSED);
+        if (reverse_ == nullptr)
+            reverse_ = new ReverseDecoder(description_, &v_frame_video_info_, timeline_, force_software_decoding_);
+#ifdef MEDIA_PLAYER_DEBUG
+        Log::Info("MediaPlayer %s Plays backward from reverse decoder", std::to_string(id_).c_str());
+#endif
+    }
+
+    GstClockTime previous = position_;
+    advance_position(now);
+
+    // display frame at position (if changed)
+    if ( position_ != GST_CLOCK_TIME_NONE && ( cached_pts_ == GST_CLOCK_TIME_NONE ||
+         position_ < cached_pts_ || position_ >= cached_pts_ + timeline_.step() ) ) {
+        GstClockTime pts = GST_CLOCK_TIME_NONE;
+        ReverseDecoder::FrameData frame = reverse_->lookup(position_, &pts);
+        if (frame) {
+            fill_cached(frame->data());
+            cached_pts_ = pts;
+            timecount_.tic();
+        }
+        // group of pictures not decoded yet: wait for it
+        else if ( previous != GST_CLOCK_TIME_NONE && rate_ < 0.0 )
+            position_ = previous;
     }
 }
 
@@ -842,7 +2156,17 @@ void MediaPlayer::update()
 
     // not ready yet
     if (!opened_) {
-        if (discoverer_.valid()) {
+        // reloading: re-create the pipeline once the previous one is stopped
+        if (stopping_.valid()) {
+            if (stopping_.wait_for( std::chrono::milliseconds(0) ) == std::future_status::ready ) {
+                // keep indexing keyframes meanwhile
+                std::future< std::vector<GstClockTime> > keyframes = std::move(keyframes_);
+                close();
+                execute_open();
+                keyframes_ = std::move(keyframes);
+            }
+        }
+        else if (discoverer_.valid()) {
             // try to get info from discoverer
             if (discoverer_.wait_for( std::chrono::milliseconds(4) ) == std::future_status::ready )
             {
@@ -851,7 +2175,19 @@ void MediaPlayer::update()
                 if (media_.valid) {
                     timeline_.setEnd( media_.end );
                     timeline_.setStep( media_.dt );
-                    execute_open();
+                    // animations are decoded once and played from memory
+                    // (by default, unless the cache was set, e.g. by the session)
+                    if ( !cache_specified_ && media_.codec_name.compare("image/gst-libav-gif") == 0 && isCacheable() )
+                        cache_enabled_ = true;
+                    // index keyframes in background (after loading all media)
+                    if ( !media_.isimage && media_.seekable && gst_uri_has_protocol(uri_.c_str(), "file") )
+                        keyframes_ = index_pool().submit< std::vector<GstClockTime> >( std::bind(MediaPlayer::UriKeyframes, uri_), index_priority_);
+                    // still image decoded: no pipeline needed
+                    if ( !image_.empty() )
+                        execute_open_image();
+                    // share decoding if possible, otherwise open pipeline
+                    else if ( !join() )
+                        execute_open();
                 }
                 else {
                     Log::Warning("MediaPlayer %s Loading cancelled", std::to_string(id_).c_str());
@@ -863,49 +2199,174 @@ void MediaPlayer::update()
         return;
     }
 
+    // resumed: continue from the position where it was suspended (once pre-rolled)
+    if ( resume_position_ != GST_CLOCK_TIME_NONE && leader_ == nullptr ) {
+        GstState state;
+        if ( gst_element_get_state (pipeline_, &state, NULL, 0) != GST_STATE_CHANGE_ASYNC ) {
+            position_ = GST_CLOCK_TIME_NONE;
+            execute_seek_command(resume_position_);
+            resume_position_ = GST_CLOCK_TIME_NONE;
+        }
+    }
+
+    // pre-rolled: play in segments from the first frame, then play
+    if ( starting_ && resume_position_ == GST_CLOCK_TIME_NONE && leader_ == nullptr ) {
+        GstState state;
+        if ( gst_element_get_state (pipeline_, &state, NULL, 0) != GST_STATE_CHANGE_ASYNC ) {
+            starting_ = false;
+            if ( !segment_.is_valid() ) {
+                GstClockTime pos = position_ != GST_CLOCK_TIME_NONE ? position_ : timeline_.begin();
+                position_ = GST_CLOCK_TIME_NONE;
+                execute_seek_command(pos);
+            }
+            if (enabled_)
+                gst_element_set_state (pipeline_, desired_state_);
+        }
+    }
+
+    // synchronized play requested: pre-rolled (after the first segment is set
+    // up), then all players of the group start together once ready
+    if ( sync_requested_ ) {
+        GstState state;
+        if ( !sync_prerolled_ && !starting_ &&
+             ( cached_ || gst_element_get_state (pipeline_, &state, NULL, 0) != GST_STATE_CHANGE_ASYNC ) )
+            sync_prerolled_ = true;
+        start_synchronized();
+    }
+
+    // keyframes index is ready
+    if ( keyframes_.valid() && keyframes_.wait_for( std::chrono::milliseconds(0) ) == std::future_status::ready ) {
+        timeline_.setKeyframes( keyframes_.get() );
+        keyframes_ = std::future< std::vector<GstClockTime> >();
+    }
+
+    // shared decoding: follow the leader, unless the timeline was changed
+    if (leader_) {
+        if ( !leader_->failed_ && timeline_.equivalent(leader_->timeline_) ) {
+            position_ = leader_->position_;
+            rate_ = leader_->rate_;
+            desired_state_ = leader_->desired_state_;
+            return;
+        }
+        split();
+    }
+
+    // copy of the file loaded in RAM (or released): decode from it (or from disk)
+    if ( pipeline_ != nullptr && memory_reading_ != ( memory_ != nullptr && memory_->ready() ) ) {
+        execute_reload_command();
+        return;
+    }
+
+    // play from RAM cache once it has all frames
+    FrameCache *cache = cache_;
+    if ( cache != nullptr && cache_enabled_ && cache->complete() && textureindex_ > 0 ) {
+        update_cached();
+        return;
+    }
+    // cache not complete anymore (e.g. evicted): back to decoding
+    else if (cached_) {
+        cached_ = false;
+        release_frame_textures();
+        GstClockTime pos = position_;
+        position_ = GST_CLOCK_TIME_NONE;
+        execute_seek_command(pos);
+        if (enabled_)
+            gst_element_set_state (pipeline_, desired_state_);
+#ifdef MEDIA_PLAYER_DEBUG
+        Log::Info("MediaPlayer %s Stops playing from RAM cache", std::to_string(id_).c_str());
+#endif
+    }
+
+    // play backward from reverse decoder
+    if ( use_reverse_decoder() && textureindex_ > 0 ) {
+        update_reversed();
+        return;
+    }
+    // playing forward again: back to decoding
+    else if (reversed_) {
+        reversed_ = false;
+        GstClockTime pos = position_;
+        position_ = GST_CLOCK_TIME_NONE;
+        execute_seek_command(pos);
+        if (enabled_)
+            gst_element_set_state (pipeline_, desired_state_);
+#ifdef MEDIA_PLAYER_DEBUG
+        Log::Info("MediaPlayer %s Stops playing from reverse decoder", std::to_string(id_).c_str());
+#endif
+    }
+
+    // still image decoded without gstreamer: texture at the size it is displayed
+    if ( media_.isimage && pipeline_ == nullptr && textureindex_ > 0 ) {
+        update_image();
+        return;
+    }
+
     // prevent unnecessary updates: disabled or already filled image
     if (!enabled_ || (media_.isimage && textureindex_>0 ) )
         return;
 
+    // decode at the resolution frames are displayed
+    // (not when sharing, caching or synchronizing frames with others)
+    if ( !media_.isimage && followers_.empty() && !cache_enabled_ &&
+         sync_group_ == GST_CLOCK_TIME_NONE && !seeking_ && textureindex_ > 0 ) {
+        guint level = adapt_decode_level(0, MEDIA_DECODE_MAX_LEVEL);
+        if (level != decode_level_) {
+            execute_scale_command(level);
+            return;
+        }
+    }
+
+    // synchronized start is done: let the pipeline track its running time again
+    if ( sync_group_ != GST_CLOCK_TIME_NONE && gst_element_get_start_time(pipeline_) == GST_CLOCK_TIME_NONE ) {
+        GstState state;
+        if ( gst_element_get_state (pipeline_, &state, NULL, 0) == GST_STATE_CHANGE_SUCCESS && state == GST_STATE_PLAYING )
+            gst_element_set_start_time(pipeline_, 0);
+    }
+
+    // end of segment was decoded: queue the next section (without flushing)
+    if (segmented_) {
+        GstBus *bus = gst_element_get_bus(pipeline_);
+        GstMessage *msg = gst_bus_pop_filtered(bus, GST_MESSAGE_SEGMENT_DONE);
+        if (msg) {
+            // looping without end of stream: is the RAM cache complete?
+            FrameCache *cache = cache_;
+            if ( cache != nullptr && cache_enabled_ && !cache->complete() )
+                cache->validate(timeline_);
+            execute_segment_command();
+            gst_message_unref(msg);
+        }
+        gst_object_unref(bus);
+    }
+
     // local variables before trying to update
-    guint read_index = 0;
     bool need_loop = false;
 
-    // locked access to current index
-    index_lock_.lock();
-    // get the last frame filled from fill_frame()
-    read_index = last_index_;
-//    // Do NOT miss and jump directly (after seek) to a pre-roll
-//    for (guint i = 0; i < N_VFRAME; ++i) {
-//        if (frame_[i].status == PREROLL) {
-//            read_index = i;
-//            break;
-//        }
-//    }
-    // unlock access to index change
-    index_lock_.unlock();
-
-    // lock frame while reading it
-    frame_[read_index].access.lock();
+    // get the last frame filled from fill_frame() (if any new)
+    int read_index = frame_queue_.read();
 
     // do not fill a frame twice
-    if (frame_[read_index].status != INVALID ) {
+    if (read_index > -1 && frame_[read_index].status != INVALID ) {
 
         // is this an End-of-Stream frame ?
         if (frame_[read_index].status == EOS )
         {
-            // will execute seek command below (after unlock)
+            // will execute seek command below (after release)
             need_loop = true;
         }
         // otherwise just fill non-empty SAMPLE or PREROLL
-        else if (frame_[read_index].full)
+        else if (frame_[read_index].filled())
         {
             // fill the texture with the frame at reading index
             fill_texture(read_index);
+            displaycount_.tic();
+
+            // had to decode this frame
+            if (cache != nullptr && cache_enabled_)
+                cache->miss();
 
-            // double update for pre-roll frame and dual PBO (ensure frame is displayed now)
-            if ( (frame_[read_index].status == PREROLL || seeking_ ) && pbo_size_ > 0)
-                fill_texture(read_index);
+            // pre-roll frame is uploaded now (ensure frame is displayed now)
+            if ( frame_[read_index].status == PREROLL || seeking_ )
+                uploader_.upload();
 
             // free frame
             frame_[read_index].unmap();
@@ -918,8 +2379,8 @@ void MediaPlayer::update()
         frame_[read_index].status = INVALID;
     }
 
-    // unkock frame after reading it
-    frame_[read_index].access.unlock();
+    // give back frame after reading it
+    frame_queue_.release();
 
     // if already seeking (asynch)
     if (seeking_) {
@@ -941,7 +2402,7 @@ void MediaPlayer::update()
                 GstClockTime jumpPts = (rate_>0.f) ? gap.end : gap.begin;
                 // seek to next valid time (if not beginnig or end of timeline)
                 if (jumpPts > timeline_.first() && jumpPts < timeline_.last())
-                    seek( jumpPts );
+                    execute_seek_command( jumpPts );
                 // otherwise, we should loop
                 else
                     need_loop = true;
@@ -956,25 +2417,188 @@ void MediaPlayer::update()
 
 }
 
+guint MediaPlayer::adapt_decode_level(guint min_level, guint max_level)
+{
+    // height of frames needed for display (full size if unknown)
+    guint needed = Settings::application.render.adaptive_decoding ? display_height_ : 0;
+
+    guint level = CLAMP(decode_level_, min_level, max_level);
+    if (needed < 1)
+        level = min_level;
+    else {
+        // displayed larger than decoded: scale up to a sufficient level
+        while ( level > min_level && (media_.height >> level) < needed )
+            --level;
+        // displayed clearly smaller than next level (20% margin): scale down
+        if (level == decode_level_) {
+            while ( level < max_level &&
+                    (media_.height >> (level + 1)) >= MEDIA_DECODE_MIN_HEIGHT &&
+                    needed * 5 < (media_.height >> (level + 1)) * 4 )
+                ++level;
+        }
+    }
+
+    // change level only if requested for a while:
+    // short delay to scale up, longer to scale down
+    guint64 now = gst_util_get_timestamp();
+    if (level != decode_level_target_) {
+        decode_level_target_ = level;
+        decode_level_time_ = now;
+    }
+    GstClockTime delay = level < decode_level_ ? GST_SECOND / 4 : 2 * GST_SECOND;
+    if ( level != decode_level_ && now - decode_level_time_ > delay )
+        return level;
+
+    return decode_level_;
+}
+
+void MediaPlayer::set_decode_size(guint width, guint height)
+{
+    GstElement *scale = gst_bin_get_by_name (GST_BIN (pipeline_), "scale");
+    if (scale) {
+        GstCaps *caps = gst_caps_new_simple ("video/x-raw", "width", G_TYPE_INT, (gint) width,
+                                             "height", G_TYPE_INT, (gint) height, NULL);
+        g_object_set (G_OBJECT (scale), "caps", caps, NULL);
+        gst_caps_unref (caps);
+        gst_object_unref (scale);
+    }
+}
+
+void MediaPlayer::execute_scale_command(guint level)
+{
+    decode_level_ = level;
+    guint width  = media_.width;
+    guint height = media_.height;
+    if (level > 0) {
+        width  = MAX( 2u, (media_.width  >> level) & ~1u );
+        height = MAX( 2u, (media_.height >> level) & ~1u );
+    }
+
+    // the pipeline renegotiates the new size with the next frame
+    // (texture is re-created by fill_texture when frames of the new size arrive)
+    set_decode_size(width, height);
+
+    // not playing: decode the current frame again, at the new size
+    if ( desired_state_ != GST_STATE_PLAYING ) {
+        GstClockTime pos = position_;
+        position_ = GST_CLOCK_TIME_NONE;
+        execute_seek_command(pos);
+    }
+
+#ifdef MEDIA_PLAYER_DEBUG
+    Log::Info("MediaPlayer %s Decodes at %d x %d", std::to_string(id_).c_str(), width, height);
+#endif
+}
+
+// Stopping a pipeline waits for its streaming threads to end:
+// done in background, one pipeline at a time.
+static WorkerPool &stopping_pool()
+{
+    static WorkerPool _pool(1);
+    return _pool;
+}
+
+static bool stop_pipeline(GstElement *pipeline)
+{
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+    gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+    gst_object_unref (pipeline);
+    return true;
+}
+
+void MediaPlayer::execute_reload_command()
+{
+    // continue from the same position once re-opened
+    if ( position_ != GST_CLOCK_TIME_NONE )
+        resume_position_ = position_;
+
+    // stop sending frames, and stop the pipeline in background
+    // (re-created by update() once stopped; the texture is displayed until then)
+    opened_ = false;
+    GstElement *pipeline = pipeline_;
+    pipeline_ = nullptr;
+    stopping_ = stopping_pool().submit<bool>( std::bind(stop_pipeline, pipeline) );
+}
+
 void MediaPlayer::execute_loop_command()
 {
+    // NB: same loop for all sharing decoding: do not diverge
     if (loop_==LOOP_REWIND) {
-        rewind();
+        execute_seek_command( rate_ > 0.0 ? timeline_.next(0) : timeline_.previous(timeline_.last()) );
     } 
     else if (loop_==LOOP_BIDIRECTIONAL) {
         rate_ *= - 1.f;
         execute_seek_command();
     }
     else { //LOOP_NONE
-        play(false);
+        execute_play_command(false);
+    }
+}
+
+void MediaPlayer::execute_segment_command()
+{
+    // next section of the timeline, in the direction of play
+    TimeInterval next = timeline_.sectionAfter( rate_ > 0.0 ? segment_.end : segment_.begin, rate_ > 0.0 );
+
+    // no more section: loop
+    if ( !next.is_valid() ) {
+        // only rewind can continue without flushing (loop mode was changed)
+        if ( loop_ != LOOP_REWIND ) {
+            execute_loop_command();
+            return;
+        }
+        next = rate_ > 0.0 ? timeline_.sectionAfter(0) : timeline_.sectionAfter(timeline_.end(), false);
+        if ( !next.is_valid() )
+            return;
+    }
+
+    // non-flushing seek: frames already decoded are still displayed
+    int seek_flags = trickmode_flags();
+    // segment done again at the end of that section
+    // (otherwise end of stream, to loop once all frames are displayed)
+    bool segment = loop_ == LOOP_REWIND || timeline_.sectionAfter( rate_ > 0.0 ? next.end : next.begin, rate_ > 0.0 ).is_valid();
+    if ( segment )
+        seek_flags |= GST_SEEK_FLAG_SEGMENT;
+
+    GstEvent *seek_event = gst_event_new_seek (rate_, GST_FORMAT_TIME, (GstSeekFlags) seek_flags,
+                                               GST_SEEK_TYPE_SET, next.begin, GST_SEEK_TYPE_SET, next.end);
+    if ( !gst_element_send_event(pipeline_, seek_event) )
+        Log::Warning("MediaPlayer %s Segment seek failed", std::to_string(id_).c_str());
+    else {
+        segment_ = next;
+        segmented_ = segment;
     }
 }
 
+int MediaPlayer::trickmode_flags() const
+{
+    if ( ABS(rate_) <= 1.0 )
+        return GST_SEEK_FLAG_NONE;
+
+    // decode only keyframes if there are enough of them at this speed
+    // (assume one keyframe per second if not indexed)
+    GstClockTime interval = timeline_.keyframeInterval();
+    if (interval == GST_CLOCK_TIME_NONE)
+        interval = GST_SECOND;
+    if ( ABS(rate_) * (double) GST_SECOND / (double) interval >= MEDIA_KEYUNITS_MIN_FPS )
+        return GST_SEEK_FLAG_TRICKMODE | GST_SEEK_FLAG_TRICKMODE_KEY_UNITS | GST_SEEK_FLAG_TRICKMODE_NO_AUDIO;
+
+    // otherwise decode all frames, the decoder may skip some
+    return GST_SEEK_FLAG_TRICKMODE;
+}
+
 void MediaPlayer::execute_seek_command(GstClockTime target)
 {
     if ( pipeline_ == nullptr || !media_.seekable )
         return;
 
+    // seek in cache or reverse decoder: only change position (frame is displayed at next update)
+    if ( cached_ || use_reverse_decoder() ) {
+        if (target != GST_CLOCK_TIME_NONE)
+            position_ = CLAMP(target, timeline_.begin(), timeline_.last());
+        return;
+    }
+
     // seek position : default to target
     GstClockTime seek_pos = target;
 
@@ -988,15 +2612,37 @@ void MediaPlayer::execute_seek_command(GstClockTime target)
         return;
     }
 
-    // seek with flush (always)
-    int seek_flags = GST_SEEK_FLAG_FLUSH;
-    // seek with trick mode if fast speed
-    if ( ABS(rate_) > 1.0 )
-        seek_flags |= GST_SEEK_FLAG_TRICKMODE;
+    // seek with flush (always), with trick mode if fast speed
+    int seek_flags = GST_SEEK_FLAG_FLUSH | trickmode_flags();
+
+    // at fast speed, let the decoder skip frames late for display (QoS)
+    GstElement *sink = gst_bin_get_by_name (GST_BIN (pipeline_), "sink");
+    if (sink) {
+        gst_base_sink_set_qos_enabled (GST_BASE_SINK(sink), ABS(rate_) > 1.0);
+        gst_object_unref (sink);
+    }
+
+    // play until the end of the section of timeline; segment done
+    // instead of end of stream when playing will continue after it
+    TimeInterval section = timeline_.sectionAfter(seek_pos, rate_ > 0.0);
+    bool segment = false;
+    if (section.is_valid()) {
+        segment = loop_ == LOOP_REWIND || timeline_.sectionAfter( rate_ > 0.0 ? section.end : section.begin, rate_ > 0.0 ).is_valid();
+        if (segment)
+            seek_flags |= GST_SEEK_FLAG_SEGMENT;
+        if (rate_ > 0)
+            section.begin = MAX(seek_pos, section.begin);
+        else
+            section.end = MIN(seek_pos, section.end);
+    }
 
     // create seek event depending on direction
     GstEvent *seek_event = nullptr;
-    if (rate_ > 0) {
+    if (section.is_valid()) {
+        seek_event = gst_event_new_seek (rate_, GST_FORMAT_TIME, (GstSeekFlags) seek_flags,
+            GST_SEEK_TYPE_SET, section.begin, GST_SEEK_TYPE_SET, section.end);
+    }
+    else if (rate_ > 0) {
         seek_event = gst_event_new_seek (rate_, GST_FORMAT_TIME, (GstSeekFlags) seek_flags,
             GST_SEEK_TYPE_SET, seek_pos, GST_SEEK_TYPE_END, 0);
     }
@@ -1005,11 +2651,22 @@ void MediaPlayer::execute_seek_command(GstClockTime target)
             GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_SET, seek_pos);
     }
 
+    // forget the end of previous segment
+    GstBus *bus = gst_element_get_bus(pipeline_);
+    GstMessage *msg = nullptr;
+    while ( (msg = gst_bus_pop_filtered(bus, GST_MESSAGE_SEGMENT_DONE)) != nullptr )
+        gst_message_unref(msg);
+    gst_object_unref(bus);
+
     // Send the event (ASYNC)
     if (seek_event && !gst_element_send_event(pipeline_, seek_event) )
         Log::Warning("MediaPlayer %s Seek failed", std::to_string(id_).c_str());
     else {
         seeking_ = true;
+        // flushing resets the running time: not synchronized anymore
+        sync_group_ = GST_CLOCK_TIME_NONE;
+        segment_ = section.is_valid() ? section : timeline_.interval();
+        segmented_ = segment;
 #ifdef MEDIA_PLAYER_DEBUG
         Log::Info("MediaPlayer %s Seek %ld %.1f", std::to_string(id_).c_str(), seek_pos, rate_);
 #endif
@@ -1023,15 +2680,81 @@ void MediaPlayer::setPlaySpeed(double s)
         return;
 
     // bound to interval [-MAX_PLAY_SPEED MAX_PLAY_SPEED] 
-    rate_ = CLAMP(s, -MAX_PLAY_SPEED, MAX_PLAY_SPEED);
+    gdouble rate = CLAMP(s, -MAX_PLAY_SPEED, MAX_PLAY_SPEED);
     // skip interval [-MIN_PLAY_SPEED MIN_PLAY_SPEED]
-    if (ABS(rate_) < MIN_PLAY_SPEED)
-        rate_ = SIGN(rate_) * MIN_PLAY_SPEED;
+    if (ABS(rate) < MIN_PLAY_SPEED)
+        rate = SIGN(rate) * MIN_PLAY_SPEED;
+
+    // change of playback state
+    if (rate != rate_)
+        diverge();
+    rate_ = rate;
         
     // apply with seek
     execute_seek_command();
 }
 
+bool MediaPlayer::isCacheable() const
+{
+    return !media_.isimage && media_.seekable && timeline_.end() != GST_CLOCK_TIME_NONE
+            && timeline_.duration() <= FRAMECACHE_MAX_DURATION;
+}
+
+bool MediaPlayer::cacheEnabled() const
+{
+    return cache_enabled_;
+}
+
+void MediaPlayer::setCacheEnabled(bool on)
+{
+    cache_enabled_ = on;
+    cache_specified_ = true;
+
+    FrameCache *cache = cache_;
+    if (on) {
+        // create cache once the pipeline is open (frame layout is known)
+        if ( cache == nullptr && pipeline_ != nullptr && isCacheable() )
+            cache_ = new FrameCache( GST_VIDEO_INFO_SIZE(&v_frame_video_info_) );
+        // or start again
+        else if ( cache != nullptr )
+            cache->reset();
+    }
+    // free memory (the pipeline takes over at next update)
+    else if ( cache != nullptr )
+        cache->clear();
+}
+
+bool MediaPlayer::isMemoryLoadable() const
+{
+    return !media_.isimage && !still_image_file(uri_) && gst_uri_has_protocol(uri_.c_str(), "file");
+}
+
+void MediaPlayer::setMemoryEnabled(bool on)
+{
+    memory_enabled_ = on;
+
+    if (on) {
+        // start loading (the pipeline reads from memory once loaded)
+        if ( ( memory_ == nullptr || memory_->failed() ) && isMemoryLoadable() ) {
+            gchar *location = gst_uri_get_location(uri_.c_str());
+            if (location) {
+                memory_ = MediaMemory::get(location);
+                g_free(location);
+            }
+        }
+    }
+    // release memory (the pipeline reads from disk at next update)
+    else
+        memory_.reset();
+}
+
+float MediaPlayer::memoryProgress() const
+{
+    if ( memory_ == nullptr || memory_->failed() )
+        return -1.f;
+    return memory_->progress();
+}
+
 double MediaPlayer::playSpeed() const
 {
     return rate_;
@@ -1079,53 +2802,114 @@ double MediaPlayer::frameRate() const
 
 double MediaPlayer::updateFrameRate() const
 {
+    if (leader_)
+        return leader_->updateFrameRate();
+
     return timecount_.frameRate();
 }
 
+double MediaPlayer::displayFrameRate() const
+{
+    if (leader_)
+        return leader_->displayFrameRate();
+
+    return displaycount_.frameRate();
+}
+
+uint64_t MediaPlayer::droppedFrames() const
+{
+    if (leader_)
+        return leader_->droppedFrames();
+
+    return frame_queue_.numDropped();
+}
+
 
 // CALLBACKS
 
-bool MediaPlayer::fill_frame(GstBuffer *buf, FrameStatus status)
+bool MediaPlayer::fill_frame(GstBuffer *buf, FrameStatus status, GstCaps *caps)
 {
-    // Do NOT overwrite an unread EOS
-    if ( frame_[write_index_].status == EOS )
-        write_index_ = (write_index_ + 1) % N_VFRAME;
+    // caps of frames changed (decode level): read their new layout
+    if ( caps != NULL && caps != sink_caps_ ) {
+        GstVideoInfo info;
+        if ( gst_video_info_from_caps(&info, caps) )
+            sink_video_info_ = info;
+        gst_caps_replace(&sink_caps_, caps);
+    }
 
-    // lock access to frame
-    frame_[write_index_].access.lock();
+    // get a frame to fill (never waits for update)
+    int write_index = frame_queue_.write();
+    if (write_index < 0)
+        return true;
 
     // always empty frame before filling it again
-    frame_[write_index_].unmap();
+    frame_[write_index].unmap();
 
     // accept status of frame received
-    frame_[write_index_].status = status;
+    frame_[write_index].status = status;
 
     // a buffer is given (not EOS)
     if (buf != NULL) {
 
         // get the frame from buffer
-        if ( !gst_video_frame_map (&frame_[write_index_].vframe, &v_frame_video_info_, buf, GST_MAP_READ ) )
+        if ( !gst_video_frame_map (&frame_[write_index].vframe, &sink_video_info_, buf, GST_MAP_READ ) )
         {
             Log::Info("MediaPlayer %s Failed to map the video buffer", std::to_string(id_).c_str());
             // free access to frame & exit
-            frame_[write_index_].status = INVALID;
-            frame_[write_index_].access.unlock();
+            frame_[write_index].status = INVALID;
+            frame_queue_.cancel();
             return false;
         }
 
         // successfully filled the frame
-        frame_[write_index_].full = true;
+        frame_[write_index].full = true;
+        frame_[write_index].info = sink_video_info_;
 
         // validate frame format
-        if( GST_VIDEO_INFO_IS_RGB(&(frame_[write_index_].vframe).info) && GST_VIDEO_INFO_N_PLANES(&(frame_[write_index_].vframe).info) == 1)
+        const GstVideoInfo *info = &(frame_[write_index].vframe).info;
+        if( ( GST_VIDEO_INFO_IS_RGB(info) && GST_VIDEO_INFO_N_PLANES(info) == 1 ) ||
+            ( yuv_ && GST_VIDEO_INFO_FORMAT(info) == GST_VIDEO_FORMAT_I420 ) )
         {
             // set presentation time stamp
-            frame_[write_index_].position = buf->pts;
+            frame_[write_index].position = buf->pts;
 
             // set the start position (i.e. pts of first frame we got)
             if (timeline_.first() == GST_CLOCK_TIME_NONE) {
                 timeline_.setFirst(buf->pts);
             }
+
+            // keep a copy in RAM cache until it has all frames
+            FrameCache *cache = cache_;
+            if ( cache != nullptr && cache_enabled_ && !cache->complete() ) {
+                // looped without end of stream (segment seek): went through the whole timeline
+                if ( cache_last_pts_ != GST_CLOCK_TIME_NONE && GST_CLOCK_TIME_IS_VALID(buf->pts) &&
+                     ( rate_ > 0.0 ? buf->pts < cache_last_pts_ : buf->pts > cache_last_pts_ ) ) {
+                    bool complete = cache->validate(timeline_);
+#ifdef MEDIA_PLAYER_DEBUG
+                    // all frames were stored after one full loop: should be complete at the second
+                    if ( !complete && ++cache_loops_ == 2 && cache->memory() > 0 )
+                        Log::Info("MediaPlayer %s Frame cache still incomplete after looping", std::to_string(id_).c_str());
+#else
+                    (void) complete;
+#endif
+                }
+                cache->store(buf->pts, &frame_[write_index].vframe, &sink_video_info_);
+                cache_last_pts_ = buf->pts;
+            }
+
+            // write the pixels in the upload ring if available and of the size of frame
+            // (otherwise keep the gst frame mapped until update)
+            PixelBufferRing *ring = pbo_ring_;
+            if ( ring && ring->slotSize() == GST_VIDEO_INFO_SIZE(&sink_video_info_) ) {
+                int slot = ring->acquire();
+                if (slot > -1) {
+                    GstToolkit::copy_video_frame(ring->data(slot), &sink_video_info_, &frame_[write_index].vframe);
+                    // release the gst buffer as early as possible
+                    frame_[write_index].unmap();
+                    frame_[write_index].ring = ring;
+                    frame_[write_index].slot = slot;
+                }
+            }
         }
         // full but invalid frame : will be deleted next iteration
         // (should never happen)
@@ -1133,29 +2917,24 @@ bool MediaPlayer::fill_frame(GstBuffer *buf, FrameStatus status)
 #ifdef MEDIA_PLAYER_DEBUG
             Log::Info("MediaPlayer %s Received an Invalid frame", std::to_string(id_).c_str());
 #endif
-            frame_[write_index_].status = INVALID;
-            frame_[write_index_].access.unlock();
+            frame_[write_index].status = INVALID;
+            frame_queue_.cancel();
             return false;
         }
     }
     // else; null buffer for EOS: give a position
     else {
-        frame_[write_index_].status = EOS;
-        frame_[write_index_].position = rate_ > 0.0 ? timeline_.end() : timeline_.begin();
-    }
+        frame_[write_index].status = EOS;
+        frame_[write_index].position = rate_ > 0.0 ? timeline_.end() : timeline_.begin();
 
-    // unlock access to frame
-    frame_[write_index_].access.unlock();
-
-    // lock access to change current index (very quick)
-    index_lock_.lock();
-    // indicate update() that this is the last frame filled (and unlocked)
-    last_index_ = write_index_;
-    // unlock access to index change
-    index_lock_.unlock();
+        // went through the whole timeline: is the RAM cache complete?
+        FrameCache *cache = cache_;
+        if ( cache != nullptr && cache_enabled_ && !cache->complete() )
+            cache->validate(timeline_);
+    }
 
-    // for writing, we will access the next in stack
-    write_index_ = (write_index_ + 1) % N_VFRAME;
+    // indicate update() that this is the last frame filled
+    frame_queue_.publish();
 
     // calculate actual FPS of update
     timecount_.tic();
@@ -1189,10 +2968,10 @@ GstFlowReturn MediaPlayer::callback_new_preroll (GstAppSink *sink, gpointer p)
             GstBuffer *buf = gst_sample_get_buffer (sample);
 
             // fill frame from buffer
-            if ( !m->fill_frame(buf, MediaPlayer::PREROLL) )
+            if ( !m->fill_frame(buf, MediaPlayer::PREROLL, gst_sample_get_caps(sample)) )
                 ret = GST_FLOW_ERROR;
-            // loop negative rate: emulate an EOS
-            else if (m->playSpeed() < 0.f && !(buf->pts > 0) ) {
+            // loop negative rate: emulate an EOS (unless segment done)
+            else if (m->playSpeed() < 0.f && !(buf->pts > 0) && !m->segmented_ ) {
                 m->fill_frame(NULL, MediaPlayer::EOS);
             }
         }
@@ -1223,11 +3002,23 @@ GstFlowReturn MediaPlayer::callback_new_sample (GstAppSink *sink, gpointer p)
             // get buffer from sample (valid until sample is released)
             GstBuffer *buf = gst_sample_get_buffer (sample) ;
 
+            // synchronized play: measure delay of frame to the shared clock
+            if ( m->sync_group_ != GST_CLOCK_TIME_NONE ) {
+                GstClock *clock = gst_element_get_clock(GST_ELEMENT(sink));
+                GstClockTime running = gst_segment_to_running_time(gst_sample_get_segment(sample), GST_FORMAT_TIME, buf->pts);
+                if ( clock != NULL && GST_CLOCK_TIME_IS_VALID(running) ) {
+                    GstClockTimeDiff offset = GST_CLOCK_DIFF( running, gst_clock_get_time(clock) - m->sync_base_ );
+                    m->sync_offset_ = ( 7 * m->sync_offset_ + offset ) / 8;
+                }
+                if (clock)
+                    gst_object_unref(clock);
+            }
+
             // fill frame with buffer
-            if ( !m->fill_frame(buf, MediaPlayer::SAMPLE) )
+            if ( !m->fill_frame(buf, MediaPlayer::SAMPLE, gst_sample_get_caps(sample)) )
                 ret = GST_FLOW_ERROR;
-            // loop negative rate: emulate an EOS
-            else if (m->playSpeed() < 0.f && !(buf->pts > 0) ) {
+            // loop negative rate: emulate an EOS (unless segment done)
+            else if (m->playSpeed() < 0.f && !(buf->pts > 0) && !m->segmented_ ) {
                 m->fill_frame(NULL, MediaPlayer::EOS);
             }
         }
@@ -1246,6 +3037,7 @@ GstFlowReturn MediaPlayer::callback_new_sample (GstAppSink *sink, gpointer p)
 MediaPlayer::TimeCounter::TimeCounter()
 {
     timer = g_timer_new ();
+    fps = 0.0;
 }
 
 MediaPlayer::TimeCounter::~TimeCounter()
@@ -2,6 +2,9 @@
 #define __GST_MEDIA_PLAYER_H_
 
 #include <string>
+#include <memory>
+#include <map>
+#include <list>
 #include <atomic>
 #include <mutex>
 #include <future>
@@ -12,13 +15,29 @@
 #include <gst/app/gstappsink.h>
 
 #include "Timeline.h"
+#include "WorkerPool.h"
+#include "FrameQueue.h"
+#include "TextureUploader.h"
 
 // Forward declare classes referenced
 class Visitor;
+class PixelBufferRing;
+class FrameBuffer;
+class Surface;
+class FrameCache;
+class ReverseDecoder;
+class MediaMemory;
 
 #define MAX_PLAY_SPEED 20.0
 #define MIN_PLAY_SPEED 0.1
 #define N_VFRAME 5
+#define MEDIA_SEEK_SNAP (GST_SECOND / 2)
+#define MEDIA_DECODE_MAX_LEVEL 2
+#define MEDIA_DECODE_MIN_HEIGHT 360
+#define MEDIA_KEYUNITS_MIN_FPS 6.0
+#define MEDIA_IMAGE_MAX_LEVEL 6
+#define MEDIA_IMAGE_MAX_SIZE 8192
+#define MEDIA_FRAME_TEXTURES_MEMORY (128 * 1048576)
 
 struct MediaInfo {
 
@@ -93,6 +112,18 @@ public:
      * */
     void open ( const std::string &filename, const std::string &uri = "");
     void reopen ();
+    /**
+     * Priority of media discovery while loading
+     * (can be changed until discovery starts),
+     * and of decoding threads (when pipeline is created)
+     * */
+    typedef enum {
+        LOAD_CURRENT = 0,
+        LOAD_NORMAL = 1,
+        LOAD_BACKGROUND = 2,
+        LOAD_INDEX = 3
+    } LoadPriority;
+    inline void setLoadPriority(LoadPriority p) { load_priority_->store(p); }
     /**
      * Get name of the media
      * */
@@ -117,6 +148,17 @@ public:
      * Close the Media
      * */
     void close();
+    /**
+     * Suspend: free the pipeline and GPU resources, keeping
+     * the playback status (timeline, position, speed, loop)
+     * */
+    void suspend();
+    /**
+     * Resume: re-create the pipeline of a suspended media player;
+     * it pre-rolls in background and continues at the same position
+     * */
+    void resume();
+    inline bool isSuspended() const { return suspended_; }
     /**
      * Update texture with latest frame
      * Must be called in rendering update loop
@@ -197,12 +239,13 @@ public:
      * pos in nanoseconds.
      * return true if seek is performed
      * */
-    bool go_to(GstClockTime pos);
+    bool go_to(GstClockTime pos, bool snap = false);
     /**
      * Seek to any position in media
      * pos in nanoseconds.
+     * snap to nearby keyframe (faster seek) if requested
      * */
-    void seek(GstClockTime pos);
+    void seek(GstClockTime pos, bool snap = false);
     /**
      * @brief timeline contains all info on timing:
      * - start position : timeline.start()
@@ -223,6 +266,22 @@ public:
      * measured during play
      * */
     double updateFrameRate() const;
+    /**
+     * Get framerate of frames displayed
+     * (can be lower than update framerate if frames are dropped)
+     * */
+    double displayFrameRate() const;
+    /**
+     * Get number of decoded frames never displayed
+     * (rendering slower than decoding)
+     * */
+    uint64_t droppedFrames() const;
+    /**
+     * Priority of texture upload (higher first, see TextureUploader)
+     * and number of frames which upload was deferred
+     * */
+    inline void setUploadPriority(float p) { uploader_.setPriority(p); }
+    inline uint64_t deferredFrames() const { return uploader_.numDeferred(); }
     /**
      * Get frame width
      * */
@@ -231,6 +290,19 @@ public:
      * Get frame height
      * */
     guint height() const;
+    /**
+     * Get size of decoded frames
+     * NB: can be lower than width() x height() (see setDisplayHeight)
+     * */
+    guint decodeWidth() const;
+    guint decodeHeight() const;
+    /**
+     * Give the height in pixels at which frames are displayed
+     * (0 if unknown) to adapt the decoding resolution:
+     * frames are scaled down by 2 or 4 when displayed smaller
+     * for a while, and back up when needed.
+     * */
+    inline void setDisplayHeight(guint h) { display_height_ = h; }
     /**
      * Get frames display aspect ratio
      * NB: can be different than width() / height()
@@ -254,10 +326,64 @@ public:
      * */
     void setSoftwareDecodingForced(bool on);
     bool softwareDecodingForced();
+    /**
+     * True if decoding is shared with other media players
+     * Media players opened on the same URI, with same timeline, speed
+     * and loop mode share the pipeline and texture of a leader; any
+     * change of playback state splits them off transparently.
+     * */
+    inline bool isShared() const { return leader_ != nullptr || !followers_.empty(); }
+    /**
+     * Keep a copy of decoded frames in RAM (short media only)
+     * Once all frames are in cache, playing, stepping, seeking
+     * and looping do not decode anymore.
+     * */
+    void setCacheEnabled(bool on);
+    bool cacheEnabled() const;
+    bool isCacheable() const;
+    /**
+     * True if frames are displayed from the RAM cache
+     * */
+    inline bool isCached() const { return cached_; }
+    /**
+     * True if frames are displayed from the reverse decoder
+     * */
+    inline bool isReversed() const { return reversed_; }
+    /**
+     * Keep a copy of the file in RAM (local files only)
+     * Once loaded, the media is decoded from memory
+     * and the disk is not accessed anymore.
+     * */
+    void setMemoryEnabled(bool on);
+    inline bool memoryEnabled() const { return memory_enabled_; }
+    bool isMemoryLoadable() const;
+    /**
+     * Fraction of the file loaded in RAM (-1 if not loading)
+     * */
+    float memoryProgress() const;
+    /**
+     * True if the media is decoded from its copy in RAM
+     * */
+    inline bool isMemoryResident() const { return memory_reading_; }
     /**
      * Accept visitors
      * */
     void accept(Visitor& v);
+    /**
+     * Start playing several media players frame synchronous:
+     * their pipelines are pre-rolled (checked at each update, never
+     * waited for), then released together with the same clock and base time
+     * */
+    static void playSynchronized(const std::list<MediaPlayer*> &players);
+    /**
+     * Start time identifying the group of synchronized play
+     * (GST_CLOCK_TIME_NONE if not synchronized)
+     * */
+    inline GstClockTime syncGroup() const { return sync_group_; }
+    /**
+     * Average delay of frames to the clock shared in synchronized play
+     * */
+    inline GstClockTimeDiff syncOffset() const { return sync_offset_; }
     /**
      * @brief registered
      * @return list of media players currently registered
@@ -267,6 +393,20 @@ public:
     static std::list<MediaPlayer*>::const_iterator end()   { return registered_.cend(); }
 
     static MediaInfo UriDiscoverer(const std::string &uri);
+    static std::vector<GstClockTime> UriKeyframes(const std::string &uri);
+    /**
+     * Write the cache of discovered media and keyframes index on disk
+     * (if changed since last save)
+     * */
+    static void saveDiscovererCache();
+    /**
+     * Largest width or height of image texture (OpenGL limit)
+     * */
+    static guint maxImageSize();
+    /**
+     * Memory used by textures of images (in bytes)
+     * */
+    static guint64 imageMemoryUsage() { return image_memory_; }
 
 private:
 
@@ -274,12 +414,16 @@ private:
     uint64_t id_;
     std::string filename_;
     std::string uri_;
+    std::string description_;
     guint textureindex_;
 
     // general properties of media
     MediaInfo media_;
     Timeline timeline_;
     std::future<MediaInfo> discoverer_;
+    WorkerPool::Priority load_priority_;
+    std::future< std::vector<GstClockTime> > keyframes_;
+    WorkerPool::Priority index_priority_;
 
     // GST & Play status
     GstClockTime position_;
@@ -287,14 +431,40 @@ private:
     LoopMode loop_;
     GstState desired_state_;
     GstElement *pipeline_;
+    std::future<bool> stopping_;
     GstVideoInfo v_frame_video_info_;
+    // layout of frames received by the appsink (streaming thread)
+    GstVideoInfo sink_video_info_;
+    GstCaps *sink_caps_;
     std::atomic<bool> opened_;
     std::atomic<bool> failed_;
     bool seeking_;
+    TimeInterval segment_;
+    std::atomic<bool> segmented_;
+    std::atomic<GstClockTime> sync_group_;
+    std::atomic<GstClockTime> sync_base_;
+    std::atomic<GstClockTimeDiff> sync_offset_;
+    bool sync_requested_;
+    bool sync_prerolled_;
+    static std::list<MediaPlayer*> sync_waiting_;
+    static GstClockTime sync_timeout_;
+    static void start_synchronized();
     bool enabled_;
+    bool suspended_;
+    GstClockTime resume_position_;
+    bool starting_;
     bool force_software_decoding_;
     std::string decoder_name_;
 
+    // adaptive decoding resolution
+    guint display_height_;
+    guint decode_level_;
+    guint decode_width_;
+    guint decode_height_;
+    guint decode_level_target_;
+    guint64 decode_level_time_;
+    guint adapt_decode_level(guint min_level, guint max_level);
+
     // fps counter
     struct TimeCounter {
         GTimer *timer;
@@ -306,6 +476,7 @@ private:
         inline gdouble frameRate() const { return fps; }
     };
     TimeCounter timecount_;
+    TimeCounter displaycount_;
 
     // frame stack
     typedef enum  {
@@ -320,34 +491,107 @@ private:
         FrameStatus status;
         bool full;
         GstClockTime position;
-        std::mutex access;
+        // slot of upload ring holding the pixels (if any)
+        PixelBufferRing *ring;
+        int slot;
+        // layout of the frame (size changes with decode level)
+        GstVideoInfo info;
 
         Frame() {
+            gst_video_info_init(&info);
             full = false;
             status = INVALID;
             position = GST_CLOCK_TIME_NONE;
+            ring = nullptr;
+            slot = -1;
         }
         void unmap();
+        inline bool filled() const { return full || slot > -1; }
     };
     Frame frame_[N_VFRAME];
-    guint write_index_;
-    guint last_index_;
-    std::mutex index_lock_;
+    FrameQueue frame_queue_;
 
     // for PBO
-    guint pbo_[2];
-    guint pbo_index_, pbo_next_index_;
-    guint pbo_size_;
+    TextureUploader uploader_;
+    std::atomic<PixelBufferRing *> pbo_ring_;
+    std::list<PixelBufferRing *> retired_rings_;
+
+    // for native YUV upload (textureindex_ is Y plane)
+    bool yuv_;
+    guint yuv_textures_[2];
+    FrameBuffer *yuv_buffer_;
+    Surface *yuv_surface_;
+
+    // RAM cache of decoded frames
+    std::atomic<FrameCache *> cache_;
+    std::atomic<bool> cache_enabled_;
+    bool cache_specified_;
+    GstClockTime cache_last_pts_;
+    guint cache_loops_;
+    bool cached_;
+    GstClockTime cached_pts_;
+    guint64 cached_time_;
+    void update_cached();
+    void fill_cached(const guint8 *data);
+    void show_cached(GstClockTime pts, const guint8 *data);
+    void advance_position(guint64 now);
+
+    // textures of cached frames (small animations)
+    std::map<GstClockTime, guint> frame_textures_;
+    guint frame_texture_;
+    void release_frame_textures();
+
+    // backward playback by decoding groups of pictures forward
+    ReverseDecoder *reverse_;
+    bool reversed_;
+    bool use_reverse_decoder() const;
+    void update_reversed();
+
+    // still image decoded without gstreamer (RGBA), at the
+    // level of reduction needed for display (texture with mipmaps)
+    std::vector<guint8> image_;
+    std::future<bool> image_loading_;
+    guint image_loading_level_;
+    guint64 image_bytes_;
+    void update_image();
+    void upload_image(guint level);
+    guint image_min_level() const;
+    static std::atomic<guint64> image_memory_;
+    static std::atomic<guint> max_image_size_;
+
+    // copy of the file in RAM
+    std::shared_ptr<MediaMemory> memory_;
+    bool memory_enabled_;
+    bool memory_reading_;
+
+    // shared decoding
+    MediaPlayer *leader_;
+    std::list<MediaPlayer *> followers_;
+    bool join();
+    void split();
+    void diverge();
 
     // gst pipeline control
     void execute_open();
+    void execute_play_command(bool on);
     void execute_loop_command();
+    void execute_segment_command();
     void execute_seek_command(GstClockTime target = GST_CLOCK_TIME_NONE);
+    void execute_scale_command(guint level);
+    void set_decode_size(guint width, guint height);
+    void execute_reload_command();
+    void execute_open_image();
+    int trickmode_flags() const;
 
     // gst frame filling
     void init_texture(guint index);
+    void release_texture();
     void fill_texture(guint index);
-    bool fill_frame(GstBuffer *buf, FrameStatus status);
+    void init_planes();
+    void convert_planes();
+    guint frame_planes(TextureUploader::Plane *planes, const GstVideoFrame *frame = nullptr,
+                       const guint8 *data = nullptr) const;
+    bool fill_frame(GstBuffer *buf, FrameStatus status, GstCaps *caps = NULL);
 
     // gst callbacks
     static void callback_end_of_stream (GstAppSink *, gpointer);
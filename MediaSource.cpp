@@ -10,6 +10,21 @@
 #include "MediaPlayer.h"
 #include "Visitor.h"
 #include "Log.h"
+#include "Mixer.h"
+
+// height of the full frame of a source displayed in output (in
+// fraction of output height): the geometry scale applies to the cropped
+// part of the frame, and the texture can be zoomed in the appearance
+static float displayed_height(Source *s)
+{
+    glm::vec3 scale = glm::abs(s->group(View::GEOMETRY)->scale_) / s->group(View::GEOMETRY)->crop_;
+    glm::vec3 zoom = glm::abs(s->group(View::TEXTURE)->scale_);
+    float h = MAX(scale.x, scale.y);
+    float z = MIN(zoom.x, zoom.y);
+    if ( z > 0.f && z < 1.f )
+        h /= z;
+    return h;
+}
 
 MediaSource::MediaSource(uint64_t id) : Source(id), path_("")
 {
@@ -78,8 +93,15 @@ void MediaSource::init()
             texturesurface_->setTextureIndex( mediaplayer_->texture() );
 
             // create Frame buffer matching size of media player
-            float height = float(mediaplayer_->width()) / mediaplayer_->aspectRatio();
-            FrameBuffer *renderbuffer = new FrameBuffer(mediaplayer_->width(), (uint)height, true);
+            // (in the limit of texture size for very large images)
+            float width = float(mediaplayer_->width());
+            float height = width / mediaplayer_->aspectRatio();
+            float fit = float(MediaPlayer::maxImageSize()) / MAX(width, height);
+            if ( mediaplayer_->isImage() && fit < 1.f ) {
+                width *= fit;
+                height *= fit;
+            }
+            FrameBuffer *renderbuffer = new FrameBuffer((uint)width, (uint)height, true);
 
             // icon in mixing view
             if (mediaplayer_->isImage())
@@ -116,6 +138,23 @@ void MediaSource::setActive (bool on)
         mediaplayer_->enable(active_);
 }
 
+void MediaSource::suspend ()
+{
+    Source::suspend();
+
+    // free pipeline and textures of media player
+    if (suspended_)
+        mediaplayer_->suspend();
+}
+
+void MediaSource::resume ()
+{
+    // re-create pipeline (pre-rolls in background)
+    mediaplayer_->resume();
+    mediaplayer_->enable(active_);
+
+    Source::resume();
+}
 
 bool MediaSource::playing () const
 {
@@ -146,6 +185,30 @@ void MediaSource::update(float dt)
 {
     Source::update(dt);
 
+    // discover (while loading) and decode current source first and sources in limbo last
+    if ( mode_ == Source::CURRENT )
+        mediaplayer_->setLoadPriority( MediaPlayer::LOAD_CURRENT );
+    else if ( glm::length( glm::vec2(groups_[View::MIXING]->translation_) ) < MIXING_LIMBO_SCALE )
+        mediaplayer_->setLoadPriority( MediaPlayer::LOAD_NORMAL );
+    else
+        mediaplayer_->setLoadPriority( MediaPlayer::LOAD_BACKGROUND );
+
+    // decode video at the resolution needed for output (source and clones)
+    if ( mediaplayer_->isOpen() && renderbuffer_ != nullptr ) {
+        float h = displayed_height(this);
+        for (auto c = clones_.begin(); c != clones_.end(); ++c)
+            h = MAX(h, displayed_height(*c));
+        Session *se = Mixer::manager().session();
+        if (se != nullptr && se->frame() != nullptr)
+            mediaplayer_->setDisplayHeight( (guint) ceil( h * se->frame()->height() ) );
+    }
+
+    // upload frames of the most visible sources first (source and clones)
+    float p = priority();
+    for (auto c = clones_.begin(); c != clones_.end(); ++c)
+        p = MAX(p, (*c)->priority());
+    mediaplayer_->setUploadPriority(p);
+
     // update video
     mediaplayer_->update();
 }
@@ -154,7 +217,10 @@ void MediaSource::render()
 {
     if ( renderbuffer_ == nullptr )
         init();
-    else {
+    // not while suspended, and once a frame is decoded after resume
+    else if ( !suspended_ && ( ready_ || mediaplayer_->texture() != Resource::getTextureBlack() ) ) {
+        // texture of media player can change (e.g. when it stops sharing decoding)
+        texturesurface_->setTextureIndex( mediaplayer_->texture() );
         // render the media player into frame buffer
         renderbuffer_->begin();
         // apply fading
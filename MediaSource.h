@@ -14,6 +14,8 @@ public:
     // implementation of source API
     void update (float dt) override;
     void setActive (bool on) override;
+    void suspend () override;
+    void resume () override;
     bool playing () const override;
     void play (bool) override;
     bool playable () const  override;
@@ -32,6 +32,8 @@
 #include "ActionManager.h"
 #include "MixingGroup.h"
 #include "Streamer.h"
+#include "TextureUploader.h"
+#include "DecoderThreads.h"
 
 #include "Mixer.h"
 
@@ -45,6 +47,9 @@ const std::chrono::milliseconds timeout_ = std::chrono::milliseconds(4);
 // static multithreaded session saving
 static void saveSession(const std::string& filename, Session *session)
 {
+    // run on all cores (not on the core of the render thread if pinned)
+    DecoderThreads::unpinThread();
+
     // lock access while saving
     session->lock();
 
@@ -67,6 +72,15 @@ static void saveSession(const std::string& filename, Session *session)
     session->unlock();
 }
 
+// static multithreaded session loading
+static Session *loadSession(const std::string& filename)
+{
+    // run on all cores (not on the core of the render thread if pinned)
+    DecoderThreads::unpinThread();
+
+    return Session::load(filename);
+}
+
 Mixer::Mixer() : session_(nullptr), back_session_(nullptr), current_view_(nullptr), dt_(0.f), dt__(0.f)
 {
     // unsused initial empty session
@@ -162,6 +176,9 @@ void Mixer::update()
     // compute stabilized dt__
     dt__ = 0.05f * dt_ + 0.95f * dt__;
 
+    // new frame for texture uploads (budget and statistics)
+    TextureUploader::nextFrame();
+
     // update session and associated sources
     session_->update(dt_);
 
@@ -978,7 +995,7 @@ void Mixer::load(const std::string& filename)
     if (sessionLoaders_.empty()) {
         // Start async thread for loading the session
         // Will be obtained in the future in update()
-        sessionLoaders_.emplace_back( std::async(std::launch::async, Session::load, filename, 0) );
+        sessionLoaders_.emplace_back( std::async(std::launch::async, loadSession, filename) );
     }
 #else
     set( Session::load(filename) );
@@ -1019,7 +1036,7 @@ void Mixer::import(const std::string& filename)
     if (sessionImporters_.empty()) {
         // Start async thread for loading the session
         // Will be obtained in the future in update()
-        sessionImporters_.emplace_back( std::async(std::launch::async, Session::load, filename, 0) );
+        sessionImporters_.emplace_back( std::async(std::launch::async, loadSession, filename) );
     }
 #else
     merge( Session::load(filename) );
@@ -12,6 +12,7 @@
 #include "SystemToolkit.h"
 #include "MediaPlayer.h"
 #include "Log.h"
+#include "SequenceReader.h"
 
 #include "MultiFileSource.h"
 
@@ -85,6 +86,30 @@ void MultiFile::open (const MultiFileSequence &sequence, uint framerate )
     if (sequence.location.empty())
         return;
 
+    // images decoded in advance by the sequence reader, given to the appsrc
+    if ( SequenceReader::supported(sequence.codec) ) {
+
+        std::ostringstream gstreamer_pipeline;
+        gstreamer_pipeline << "appsrc name=src caps=\"video/x-raw,format=RGBA,width=";
+        gstreamer_pipeline << sequence.width;
+        gstreamer_pipeline << ",height=";
+        gstreamer_pipeline << sequence.height;
+        gstreamer_pipeline << ",framerate=(fraction)";
+        gstreamer_pipeline << framerate;
+        gstreamer_pipeline << "/1\" ! videoconvert";
+
+        // (private) open stream (closes previous reader)
+        Stream::open(gstreamer_pipeline.str(), sequence.width, sequence.height);
+
+        reader_ = std::make_shared<SequenceReader>(sequence.location, sequence.width, sequence.height, framerate);
+        reader_->setRange(sequence.min, sequence.max, true);
+
+        src_ = gst_bin_get_by_name (GST_BIN (pipeline_), "src");
+        SequenceReader::setup_source(src_, reader_);
+        return;
+    }
+
+    // otherwise images read and decoded by gstreamer
     std::ostringstream gstreamer_pipeline;
     gstreamer_pipeline << "multifilesrc name=src location=\"";
     gstreamer_pipeline << sequence.location;
@@ -113,11 +138,16 @@ void MultiFile::close ()
         src_ = nullptr;
     }
     Stream::close();
+
+    // pending decoding is cancelled when the appsrc releases the reader
+    reader_.reset();
 }
 
 void MultiFile::setIndex(int val)
 {
-    if (src_) {
+    if (reader_)
+        reader_->setIndex(val);
+    else if (src_) {
         g_object_set (src_, "index", val, NULL);
     }
 }
@@ -125,7 +155,9 @@ void MultiFile::setIndex(int val)
 int MultiFile::index()
 {
     int val = 0;
-    if (src_) {
+    if (reader_)
+        val = reader_->index();
+    else if (src_) {
         g_object_get (src_, "index", &val, NULL);
     }
     return val;
@@ -133,7 +165,9 @@ int MultiFile::index()
 
 void MultiFile::setProperties (int begin, int end, int loop)
 {
-    if (src_) {
+    if (reader_)
+        reader_->setRange(MAX(begin, 0), MAX(end, 0), loop > 0);
+    else if (src_) {
         g_object_set (src_, "start-index", MAX(begin, 0), NULL);
         g_object_set (src_, "stop-index", MAX(end, 0), NULL);
         g_object_set (src_, "loop", MIN(loop, 1), NULL);
@@ -3,9 +3,12 @@
 
 #include <string>
 #include <list>
+#include <memory>
 
 #include "StreamSource.h"
 
+class SequenceReader;
+
 struct MultiFileSequence {
     std::string location;
     std::string codec;
@@ -28,7 +31,7 @@ public:
     void open (const MultiFileSequence &sequence, uint framerate = 30);
     void close () override;
 
-    // dynamic change of gstreamer multifile source properties
+    // dynamic change of multifile source properties
     void setProperties(int begin, int end, int loop);
 
     // image index
@@ -37,6 +40,7 @@ public:
 
 protected:
     GstElement *src_ ;
+    std::shared_ptr<SequenceReader> reader_;
 };
 
 class MultiFileSource : public StreamSource
@@ -4,6 +4,8 @@
 #include "PatternSource.h"
 
 #include "defines.h"
+#include "FrameBuffer.h"
+#include "Primitives.h"
 #include "ImageShader.h"
 #include "Resource.h"
 #include "Decorations.h"
@@ -93,11 +95,28 @@ std::vector<std::string> Pattern::pattern_types = { "Black",
                                                     #endif
                                                   };
 
-Pattern::Pattern() : Stream(), type_(MAX_PATTERN) // invalid pattern
+Pattern::Pattern() : Stream(), type_(MAX_PATTERN), // invalid pattern
+    generated_(false), framebuffer_(nullptr), surface_(nullptr), shader_(nullptr),
+    time_(0), timestamp_(GST_CLOCK_TIME_NONE)
 {
 
 }
 
+Pattern::~Pattern()
+{
+    // surface deletes its shader
+    if (surface_)
+        delete surface_;
+    if (framebuffer_)
+        delete framebuffer_;
+}
+
+bool Pattern::generated(uint pattern)
+{
+    // Lissajous, Blob, Timer and Clock need gstreamer
+    return pattern != 6 && pattern < 21;
+}
+
 glm::ivec2 Pattern::resolution()
 {
     return glm::ivec2( width_, height_);
@@ -107,6 +126,27 @@ glm::ivec2 Pattern::resolution()
 void Pattern::open( uint pattern, glm::ivec2 res )
 {
     type_ = MIN(pattern, MAX_PATTERN-1);
+
+    // all patterns before 'SMPTE test pattern' are single frames (not animated)
+    single_frame_ = type_ < 14;
+
+    // pattern generated by shader: no pipeline to open
+    if ( generated(type_) ) {
+        if (isOpen())
+            close();
+        generated_ = true;
+        description_ = "shader pattern " + pattern_types[type_];
+        width_ = res.x;
+        height_ = res.y;
+        time_ = 0;
+        timestamp_ = GST_CLOCK_TIME_NONE;
+        textureinitialized_ = false;
+        failed_ = false;
+        opened_ = true;
+        return;
+    }
+    generated_ = false;
+
     std::string gstreamer_pattern = pattern_internal_[type_];
 
     // there is always a special case...
@@ -124,14 +164,85 @@ void Pattern::open( uint pattern, glm::ivec2 res )
         break;
     }
 
-    // all patterns before 'SMPTE test pattern' are single frames (not animated)
-    single_frame_ = type_ < 14;
     Log::Info("Stream %d SingleFrame", single_frame_);
 
     // (private) open stream
     Stream::open(gstreamer_pattern, res.x, res.y);
 }
 
+void Pattern::update()
+{
+    if (!generated_) {
+        Stream::update();
+        return;
+    }
+
+    // not ready yet
+    if (!opened_ || failed_)
+        return;
+
+    // nothing new to draw if image or paused
+    if ( textureinitialized_ && ( single_frame_ || !enabled_ || desired_state_ != GST_STATE_PLAYING ) ) {
+        timestamp_ = GST_CLOCK_TIME_NONE;
+        return;
+    }
+
+    // animation time advances only while playing
+    GstClockTime now = gst_util_get_timestamp();
+    if (timestamp_ != GST_CLOCK_TIME_NONE)
+        time_ += now - timestamp_;
+    timestamp_ = now;
+
+    // create frame buffer at resolution of pattern
+    if ( framebuffer_ == nullptr || framebuffer_->width() != width_ || framebuffer_->height() != height_ ) {
+        if (framebuffer_)
+            delete framebuffer_;
+        framebuffer_ = new FrameBuffer(width_, height_);
+    }
+    if ( surface_ == nullptr ) {
+        shader_ = new PatternShader;
+        surface_ = new Surface(shader_);
+    }
+
+    // draw pattern into frame buffer
+    shader_->pattern = (int) type_;
+    shader_->time = (float) ( (double) time_ / (double) GST_SECOND );
+    framebuffer_->begin(false);
+    surface_->draw(glm::identity<glm::mat4>(), framebuffer_->projection());
+    framebuffer_->end();
+
+    textureinitialized_ = true;
+    position_ = time_;
+    timecount_.tic();
+}
+
+void Pattern::rewind()
+{
+    if (generated_)
+        time_ = 0;
+    else
+        Stream::rewind();
+}
+
+GstClockTime Pattern::position()
+{
+    if (generated_)
+        return time_;
+
+    return Stream::position();
+}
+
+guint Pattern::texture() const
+{
+    if (generated_) {
+        if (framebuffer_ == nullptr)
+            return Resource::getTextureBlack();
+        return framebuffer_->texture();
+    }
+
+    return Stream::texture();
+}
+
 PatternSource::PatternSource(uint64_t id) : StreamSource(id)
 {
     // create stream
@@ -154,6 +265,15 @@ void PatternSource::setPattern(uint type, glm::ivec2 resolution)
     ready_ = false;
 }
 
+void PatternSource::update(float dt)
+{
+    StreamSource::update(dt);
+
+    // texture changes when switching between generated and gstreamer patterns
+    if (renderbuffer_ && stream_)
+        texturesurface_->setTextureIndex( stream_->texture() );
+}
+
 void PatternSource::accept(Visitor& v)
 {
     Source::accept(v);
@@ -5,19 +5,50 @@
 
 #include "StreamSource.h"
 
+class FrameBuffer;
+class Surface;
+class PatternShader;
+
+/**
+ * @brief The Pattern class
+ *
+ * Most patterns are generated by a shader, directly into a frame
+ * buffer on GPU (no gstreamer pipeline, no decoding nor upload).
+ * The others (Lissajous, Blob, Timer and Clock) are produced by
+ * a gstreamer pipeline.
+ */
 class Pattern : public Stream
 {
 public:
     static std::vector<std::string> pattern_types;
 
     Pattern();
+    ~Pattern();
     void open( uint pattern, glm::ivec2 res);
 
+    // Stream interface
+    void update() override;
+    void rewind() override;
+    GstClockTime position() override;
+    guint texture() const override;
+
     glm::ivec2 resolution();
     inline uint type() const { return type_; }
+    /**
+     * True if the pattern is generated by a shader
+     * */
+    static bool generated(uint pattern);
 
 private:
     uint type_;
+
+    // generated on GPU
+    bool generated_;
+    FrameBuffer *framebuffer_;
+    Surface *surface_;
+    PatternShader *shader_;
+    GstClockTime time_;
+    GstClockTime timestamp_;
 };
 
 class PatternSource : public StreamSource
@@ -31,6 +62,9 @@ public:
     // StreamSource interface
     Stream *stream() const override { return stream_; }
 
+    // StreamSource interface
+    void update (float dt) override;
+
     // specific interface
     Pattern *pattern() const;
     void setPattern(uint type, glm::ivec2 resolution);
@@ -0,0 +1,174 @@
+//  Desktop OpenGL function loader
+#include <glad/glad.h>
+
+#include "Log.h"
+#include "PixelBufferRing.h"
+
+#ifndef NDEBUG
+#define PIXELBUFFERRING_DEBUG
+#endif
+
+// alignment of slots in the buffer (bytes)
+#define PIXELBUFFERRING_ALIGN 256
+
+std::list<PixelBufferRing*> PixelBufferRing::rings_;
+
+bool PixelBufferRing::supported()
+{
+    static int support = -1;
+
+    // test only once
+    if (support < 0) {
+        // persistent mapping is core in OpenGL 4.4 or provided by extension
+        support = GLAD_GL_ARB_buffer_storage ? 1 : 0;
+        if (support > 0)
+            Log::Info("OpenGL persistent mapped pixel buffers enabled.");
+        else
+            Log::Info("OpenGL persistent mapped pixel buffers not supported; using dual PBO.");
+    }
+
+    return support > 0;
+}
+
+guint64 PixelBufferRing::mappedMemory()
+{
+    guint64 total = 0;
+    for (auto r = rings_.cbegin(); r != rings_.cend(); ++r)
+        total += (*r)->valid() ? (*r)->stride_ * (*r)->n_ : 0;
+    return total;
+}
+
+PixelBufferRing::PixelBufferRing(guint slot_size, guint n) : buffer_(0), data_(nullptr),
+    slot_size_(slot_size), n_(MAX(n, 2)), next_(0)
+{
+    // each slot starts at an aligned offset
+    stride_ = ( (slot_size_ + PIXELBUFFERRING_ALIGN - 1) / PIXELBUFFERRING_ALIGN ) * PIXELBUFFERRING_ALIGN;
+
+    status_ = new std::atomic<int>[n_];
+    fence_  = new GLsync[n_];
+    for (guint i = 0; i < n_; ++i) {
+        status_[i] = SLOT_FREE;
+        fence_[i] = 0;
+    }
+
+    if ( supported() && slot_size_ > 0 ) {
+        // allocate immutable storage for all slots
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr size = static_cast<GLsizeiptr>(stride_) * n_;
+        glGenBuffers(1, &buffer_);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, NULL, flags);
+        // map it once and for all
+        data_ = (guint8 *) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (data_ == nullptr) {
+            Log::Warning("Failed to map persistent pixel buffer of %ld bytes.", (long) size);
+            glDeleteBuffers(1, &buffer_);
+            buffer_ = 0;
+        }
+#ifdef PIXELBUFFERRING_DEBUG
+        else
+            Log::Info("Persistent pixel buffer ring of %d x %d bytes.", n_, stride_);
+#endif
+    }
+
+    rings_.push_back(this);
+}
+
+PixelBufferRing::~PixelBufferRing()
+{
+    rings_.remove(this);
+
+    for (guint i = 0; i < n_; ++i) {
+        if (fence_[i])
+            glDeleteSync(fence_[i]);
+    }
+
+    if (buffer_) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &buffer_);
+    }
+
+    delete [] status_;
+    delete [] fence_;
+}
+
+int PixelBufferRing::acquire()
+{
+    if (data_ == nullptr)
+        return -1;
+
+    // round robin search for a free slot, starting after the last given
+    guint start = next_.fetch_add(1);
+    for (guint i = 0; i < n_; ++i) {
+        int slot = (start + i) % n_;
+        int expected = SLOT_FREE;
+        if ( status_[slot].compare_exchange_strong(expected, SLOT_WRITING) )
+            return slot;
+    }
+
+    // all slots are busy (GPU is late)
+    return -1;
+}
+
+guint8 *PixelBufferRing::data(int slot) const
+{
+    if (data_ == nullptr || slot < 0 || slot >= (int) n_)
+        return nullptr;
+
+    return data_ + static_cast<size_t>(stride_) * slot;
+}
+
+void PixelBufferRing::release(int slot)
+{
+    if (slot < 0 || slot >= (int) n_)
+        return;
+
+    int expected = SLOT_WRITING;
+    status_[slot].compare_exchange_strong(expected, SLOT_FREE);
+}
+
+void PixelBufferRing::upload(int slot, guint w, guint h, guint format, guint type, guint offset)
+{
+    if (data_ == nullptr || slot < 0 || slot >= (int) n_)
+        return;
+
+    // copy pixels from the slot of the PBO to the bound texture object
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h, format, type,
+                    (void *) (static_cast<size_t>(stride_) * slot + offset));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void PixelBufferRing::lock(int slot)
+{
+    if (data_ == nullptr || slot < 0 || slot >= (int) n_)
+        return;
+
+    // protect the slot until the GPU is done reading it
+    if (fence_[slot])
+        glDeleteSync(fence_[slot]);
+    fence_[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    status_[slot] = SLOT_PENDING;
+
+    // opportunity to give back slots of previous uploads
+    recycle();
+}
+
+void PixelBufferRing::recycle()
+{
+    for (guint i = 0; i < n_; ++i) {
+        if (status_[i] == SLOT_PENDING && fence_[i]) {
+            // non-blocking test of the fence
+            GLenum r = glClientWaitSync(fence_[i], 0, 0);
+            if (r == GL_ALREADY_SIGNALED || r == GL_CONDITION_SATISFIED) {
+                glDeleteSync(fence_[i]);
+                fence_[i] = 0;
+                status_[i] = SLOT_FREE;
+            }
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef PIXELBUFFERRING_H
+#define PIXELBUFFERRING_H
+
+#include <atomic>
+#include <list>
+
+#include <glib.h>
+
+#define PIXELBUFFERRING_DEFAULT_SLOTS 4
+
+typedef struct __GLsync *GLsync;
+
+/**
+ * @brief The PixelBufferRing class
+ *
+ * Ring of N slots of pixels inside one OpenGL Pixel Buffer Object
+ * that is mapped once and for all in client memory (persistent &
+ * coherent mapping, ARB_buffer_storage).
+ *
+ * The producer (e.g. gstreamer appsink thread) can write directly
+ * into the mapped memory of a slot (acquire, then data), without any
+ * OpenGL call; the mapping is write-only and must never be read from
+ * client side. The rendering thread then only issues a
+ * glTexSubImage2D from the offset of the slot in the buffer (upload,
+ * scheduled by TextureUploader with the other uploads), and a fence
+ * guards the slot until the GPU is done with it (lock).
+ *
+ * All rings share the same engine: support is tested once, and
+ * the list of rings in use is kept to report memory usage.
+ */
+class PixelBufferRing
+{
+public:
+    /**
+     * Create a ring of n slots of given size in bytes
+     * Must be called in OpenGL context
+     * */
+    PixelBufferRing(guint slot_size, guint n = PIXELBUFFERRING_DEFAULT_SLOTS);
+    /**
+     * Destructor.
+     * Must be called in OpenGL context
+     * */
+    ~PixelBufferRing();
+    /**
+     * True if persistent mapping could be established
+     * */
+    inline bool valid() const { return data_ != nullptr; }
+    /**
+     * Get size of a slot (in bytes)
+     * */
+    inline guint slotSize() const { return slot_size_; }
+    /**
+     * Get number of slots
+     * */
+    inline guint numSlots() const { return n_; }
+    /**
+     * Reserve a free slot for writing
+     * Can be called from any thread (lock-free)
+     * returns -1 if no slot is free
+     * */
+    int acquire();
+    /**
+     * Get the client memory mapped for the slot (write only)
+     * Can be called from any thread after acquire()
+     * */
+    guint8 *data(int slot) const;
+    /**
+     * Release a slot without uploading it
+     * Can be called from any thread
+     * */
+    void release(int slot);
+    /**
+     * Upload the content of the slot, starting at offset, into
+     * the currently bound GL_TEXTURE_2D (full image of w x h with
+     * the given format). Can be called for each plane of a frame.
+     * Must be called in OpenGL context
+     * */
+    void upload(int slot, guint w, guint h, guint format, guint type, guint offset = 0);
+    /**
+     * Place a fence to protect the slot until transfer is done
+     * (to be called once all uploads of the slot are issued)
+     * Must be called in OpenGL context
+     * */
+    void lock(int slot);
+    /**
+     * Free the slots which transfer is over
+     * Must be called in OpenGL context
+     * */
+    void recycle();
+
+    // shared engine
+    /**
+     * True if the OpenGL context can provide persistent mapping
+     * Must be called in OpenGL context
+     * */
+    static bool supported();
+    /**
+     * Total amount of memory mapped by all rings (in bytes)
+     * */
+    static guint64 mappedMemory();
+    /**
+     * Number of rings in use
+     * */
+    static size_t numRings() { return rings_.size(); }
+
+private:
+
+    typedef enum {
+        SLOT_FREE = 0,
+        SLOT_WRITING,
+        SLOT_PENDING
+    } SlotStatus;
+
+    guint buffer_;
+    guint8 *data_;
+    guint slot_size_;
+    guint stride_;
+    guint n_;
+    std::atomic<int> *status_;
+    GLsync *fence_;
+    std::atomic<guint> next_;
+
+    // global list of rings
+    static std::list<PixelBufferRing*> rings_;
+};
+
+#endif // PIXELBUFFERRING_H
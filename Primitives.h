@@ -102,6 +102,7 @@ public:
     void accept (Visitor& v) override;
 
     inline FrameBuffer *getFrameBuffer() const { return frame_buffer_; }
+    inline void setFrameBuffer(FrameBuffer *fb) { frame_buffer_ = fb; }
 
 protected:
     FrameBuffer *frame_buffer_;
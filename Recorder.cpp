@@ -17,6 +17,7 @@
 #include "SystemToolkit.h"
 #include "FrameBuffer.h"
 #include "Log.h"
+#include "DecoderThreads.h"
 
 #include "Recorder.h"
 
@@ -43,6 +44,9 @@ void PNGRecorder::init(GstCaps *caps)
         return;
     }
 
+    // streaming threads run on all cores (if render thread is pinned)
+    DecoderThreads::unpinStreamingThreads(pipeline_);
+
     // verify location path (path is always terminated by the OS dependent separator)
     std::string path = SystemToolkit::path_directory(Settings::application.record.path);
     if (path.empty())
@@ -244,6 +248,9 @@ void VideoRecorder::init(GstCaps *caps)
         return;
     }
 
+    // streaming threads run on all cores (if render thread is pinned)
+    DecoderThreads::unpinStreamingThreads(pipeline_);
+
     // setup file sink
     g_object_set (G_OBJECT (gst_bin_get_by_name (GST_BIN (pipeline_), "sink")),
                   "location", filename_.c_str(),
@@ -0,0 +1,200 @@
+#include "defines.h"
+#include "Log.h"
+#include "GstToolkit.h"
+#include "DecoderThreads.h"
+
+#include "ReverseDecoder.h"
+
+#ifndef NDEBUG
+#define REVERSEDECODER_DEBUG
+#endif
+
+WorkerPool &ReverseDecoder::pool()
+{
+    return DecoderThreads::pool();
+}
+
+ReverseDecoder::ReverseDecoder(const std::string &description, const GstVideoInfo *info,
+                               const Timeline &timeline, bool software) :
+    description_(description), timeline_(timeline), software_(software),
+    pipeline_(nullptr), sink_(nullptr), failed_(false)
+{
+    info_ = *info;
+    priority_ = WorkerPool::priority();
+
+    // two groups in memory: the one displayed and the one decoded
+    max_frames_ = MAX( (size_t) REVERSE_DECODER_MIN_FRAMES, (size_t) (REVERSE_DECODER_MEMORY / 2 / GST_VIDEO_INFO_SIZE(&info_)) );
+}
+
+ReverseDecoder::~ReverseDecoder()
+{
+    // cancel decoding if not started, or wait for it to finish
+    if (next_.valid()) {
+        pool().cancel(priority_);
+        next_.wait();
+    }
+
+    if (sink_)
+        gst_object_unref (sink_);
+
+    if (pipeline_) {
+        gst_element_set_state (pipeline_, GST_STATE_NULL);
+        gst_object_unref (pipeline_);
+    }
+}
+
+bool ReverseDecoder::init()
+{
+    GError *error = NULL;
+    pipeline_ = gst_parse_launch (description_.c_str(), &error);
+    if (error != NULL) {
+        Log::Warning("Reverse decoding: Could not construct pipeline %s:\n%s", description_.c_str(), error->message);
+        g_clear_error (&error);
+        return false;
+    }
+
+    // same decoders as the media player
+    if (software_) {
+        GstElement *decoder = gst_bin_get_by_name (GST_BIN (pipeline_), "decoder");
+        if (decoder) {
+            g_object_set (G_OBJECT (decoder), "force-sw-decoders", true,  NULL);
+            gst_object_unref (decoder);
+        }
+    }
+
+    // share the decoding threads with other pipelines
+    DecoderThreads::setup(pipeline_);
+
+    // same frames as the media player
+    sink_ = gst_bin_get_by_name (GST_BIN (pipeline_), "sink");
+    if (!sink_) {
+        Log::Warning("Reverse decoding: Could not configure sink");
+        return false;
+    }
+    GstCaps *caps = gst_video_info_to_caps (&info_);
+    gst_app_sink_set_caps (GST_APP_SINK(sink_), caps);
+    gst_caps_unref (caps);
+
+    // decode as fast as possible, without losing frames
+    gst_base_sink_set_sync (GST_BASE_SINK(sink_), false);
+    gst_app_sink_set_max_buffers (GST_APP_SINK(sink_), 2);
+    gst_app_sink_set_drop (GST_APP_SINK(sink_), false);
+    gst_app_sink_set_emit_signals (GST_APP_SINK(sink_), false);
+
+    // pre-roll
+    if ( gst_element_set_state (pipeline_, GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE ||
+         gst_element_get_state (pipeline_, NULL, NULL, 5 * GST_SECOND) != GST_STATE_CHANGE_SUCCESS ) {
+        Log::Warning("Reverse decoding: Could not open media");
+        return false;
+    }
+
+    return true;
+}
+
+ReverseDecoder::ChunkPtr ReverseDecoder::decode(GstClockTime end)
+{
+    ChunkPtr chunk = std::make_shared<Chunk>();
+    chunk->end = end;
+    chunk->begin = timeline_.keyframeBefore( end > 0 ? end - 1 : 0 );
+
+    if ( failed_ || ( pipeline_ == nullptr && !init() ) ) {
+        failed_ = true;
+        return chunk;
+    }
+
+    // decode forward from the keyframe, until end (excluded)
+    if ( !gst_element_seek (pipeline_, 1.0, GST_FORMAT_TIME,
+                            (GstSeekFlags) (GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE),
+                            GST_SEEK_TYPE_SET, chunk->begin, GST_SEEK_TYPE_SET, end) ) {
+        Log::Warning("Reverse decoding: Seek failed");
+        failed_ = true;
+        return chunk;
+    }
+    gst_element_set_state (pipeline_, GST_STATE_PLAYING);
+
+    bool trimmed = false;
+    GstSample *sample = NULL;
+    // until end of stream (i.e. end of segment)
+    while ( (sample = gst_app_sink_try_pull_sample (GST_APP_SINK(sink_), GST_SECOND)) != NULL ) {
+        GstBuffer *buf = gst_sample_get_buffer (sample);
+        GstVideoFrame vframe;
+        if ( buf != NULL && GST_BUFFER_PTS_IS_VALID(buf) && buf->pts < end &&
+             gst_video_frame_map (&vframe, &info_, buf, GST_MAP_READ) ) {
+            FrameData data = std::make_shared< std::vector<guint8> >( GST_VIDEO_INFO_SIZE(&info_) );
+            GstToolkit::copy_video_frame( data->data(), &info_, &vframe );
+            gst_video_frame_unmap (&vframe);
+            chunk->frames[buf->pts] = data;
+            // keep only the last frames before end
+            if ( chunk->frames.size() > max_frames_ ) {
+                chunk->frames.erase( chunk->frames.begin() );
+                trimmed = true;
+            }
+        }
+        gst_sample_unref (sample);
+    }
+
+    // decoder is idle until next request
+    gst_element_set_state (pipeline_, GST_STATE_PAUSED);
+
+    // group too long: the previous frames will be decoded in another pass
+    if ( trimmed )
+        chunk->begin = chunk->frames.begin()->first;
+
+#ifdef REVERSEDECODER_DEBUG
+    Log::Info("Reverse decoding: %ld frames [%ld %ld]", chunk->frames.size(), chunk->begin, chunk->end);
+#endif
+
+    return chunk;
+}
+
+void ReverseDecoder::request(GstClockTime end)
+{
+    next_ = pool().submit<ChunkPtr>( std::bind(&ReverseDecoder::decode, this, end), priority_ );
+}
+
+ReverseDecoder::FrameData ReverseDecoder::lookup(GstClockTime t, GstClockTime *pts)
+{
+    auto covers = [t](const ChunkPtr &c) {
+        return c && !c->frames.empty() && c->begin <= t && t < c->end;
+    };
+
+    // take the group decoded meanwhile (if useful), or keep it
+    // for later if it is the group before the one displayed
+    if ( next_.valid() && next_.wait_for( std::chrono::milliseconds(0) ) == std::future_status::ready ) {
+        ChunkPtr c = next_.get();
+        if ( covers(c) || !covers(current_) )
+            current_ = c;
+        else
+            previous_ = c;
+    }
+
+    // reached the group before
+    if ( !covers(current_) && covers(previous_) ) {
+        current_ = previous_;
+        previous_.reset();
+    }
+
+    FrameData frame;
+    if ( covers(current_) ) {
+        // closest frame before t (or first of the group)
+        auto f = current_->frames.upper_bound(t);
+        if ( f != current_->frames.begin() )
+            --f;
+        frame = f->second;
+        *pts = f->first;
+
+        // prepare the previous group (unless already decoded)
+        bool prepared = previous_ && previous_->end == current_->begin;
+        if ( !next_.valid() && !prepared && current_->begin > timeline_.begin() ) {
+            previous_.reset();
+            request(current_->begin);
+        }
+    }
+    // not decoded: request the group of t (once)
+    else if ( !next_.valid() && !failed_ ) {
+        previous_.reset();
+        request(t + 1);
+    }
+
+    return frame;
+}
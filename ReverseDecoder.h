@@ -0,0 +1,89 @@
+#ifndef REVERSEDECODER_H
+#define REVERSEDECODER_H
+
+#include <atomic>
+#include <memory>
+#include <future>
+#include <vector>
+#include <map>
+#include <string>
+
+#include <gst/video/video.h>
+#include <gst/app/gstappsink.h>
+
+#include "Timeline.h"
+#include "WorkerPool.h"
+
+// memory for frames decoded in advance (per media player)
+#define REVERSE_DECODER_MEMORY (512 * 1048576)
+#define REVERSE_DECODER_MIN_FRAMES 8
+
+/**
+ * @brief The ReverseDecoder class
+ *
+ * Plays a media backward by decoding forward: the group of pictures
+ * before the displayed frame is decoded in RAM once (from its keyframe),
+ * and its frames are given in reverse order while the previous group is
+ * decoded by a worker thread.
+ *
+ * A group too long to fit in memory is decoded in several passes from
+ * its keyframe, each keeping only the last frames before the previous.
+ *
+ * The decoding pipeline is created at first request, with the same
+ * description and frame layout as the pipeline of the media player.
+ */
+class ReverseDecoder
+{
+public:
+    typedef std::shared_ptr< std::vector<guint8> > FrameData;
+
+    ReverseDecoder(const std::string &description, const GstVideoInfo *info,
+                   const Timeline &timeline, bool software);
+    ~ReverseDecoder();
+    // non assignable class
+    ReverseDecoder(ReverseDecoder const&) = delete;
+    ReverseDecoder& operator=(ReverseDecoder const&) = delete;
+
+    /**
+     * Get the frame to display at time t (i.e. closest frame before)
+     * returns empty FrameData if not decoded yet (and requests it);
+     * pts is set if a frame is returned
+     * */
+    FrameData lookup(GstClockTime t, GstClockTime *pts);
+    /**
+     * True if decoding is not possible
+     * */
+    inline bool failed() const { return failed_; }
+
+private:
+    struct Chunk {
+        GstClockTime begin;
+        GstClockTime end;
+        std::map<GstClockTime, FrameData> frames;
+    };
+    typedef std::shared_ptr<Chunk> ChunkPtr;
+
+    // consumer side
+    ChunkPtr current_;
+    ChunkPtr previous_;
+    std::future<ChunkPtr> next_;
+    void request(GstClockTime end);
+
+    // worker side
+    ChunkPtr decode(GstClockTime end);
+    bool init();
+
+    std::string description_;
+    GstVideoInfo info_;
+    Timeline timeline_;
+    bool software_;
+    size_t max_frames_;
+    GstElement *pipeline_;
+    GstElement *sink_;
+    std::atomic<bool> failed_;
+    WorkerPool::Priority priority_;
+
+    static WorkerPool &pool();
+};
+
+#endif // REVERSEDECODER_H
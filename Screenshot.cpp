@@ -11,6 +11,8 @@
 #include <stb_image.h>
 #include <stb_image_write.h>
 
+#include "DecoderThreads.h"
+
 
 
 Screenshot::Screenshot()
@@ -122,6 +124,9 @@ void Screenshot::FlipVertical()
 // Thread to perform slow operation of saving to file
 void Screenshot::storeToFile(Screenshot *s, std::string filename)
 {
+    // run on all cores (not on the core of the render thread if pinned)
+    DecoderThreads::unpinThread();
+
     static std::atomic<bool> ScreenshotSavePending_ = false;
     // only one save at a time
     if (ScreenshotSavePending_)
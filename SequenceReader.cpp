@@ -0,0 +1,285 @@
+#include <cstring>
+
+#include <gst/app/gstappsrc.h>
+
+#include <stb_image.h>
+
+#include "defines.h"
+#include "Log.h"
+#include "DecoderThreads.h"
+
+#include "SequenceReader.h"
+
+WorkerPool &SequenceReader::pool()
+{
+    return DecoderThreads::pool();
+}
+
+bool SequenceReader::supported(const std::string &codec)
+{
+    return codec == "png" || codec == "jpeg" || codec == "bmp";
+}
+
+SequenceReader::SequenceReader(const std::string &location, guint width, guint height,
+                               guint framerate, guint prefetch) :
+    location_(location), width_(width), height_(height), framerate_(MAX(framerate, 1)),
+    prefetch_(MAX(prefetch, 1)), begin_(0), end_(0), loop_(true), next_(0), current_(0),
+    ended_(false), count_(0), pushed_(false)
+{
+    priority_ = WorkerPool::priority();
+}
+
+SequenceReader::~SequenceReader()
+{
+    // cancel decoding not started, and wait for the others to finish
+    pool().cancel(priority_);
+    for (auto f = frames_.begin(); f != frames_.end(); ++f)
+        f->second.wait();
+}
+
+std::string SequenceReader::filename(int index) const
+{
+    std::vector<char> name(location_.size() + 32);
+    snprintf(name.data(), name.size(), location_.c_str(), index);
+    return std::string(name.data());
+}
+
+SequenceReader::FrameData SequenceReader::decode(const std::string &filename, guint width, guint height)
+{
+    FrameData frame;
+
+    // read file mapped in memory
+    GError *error = NULL;
+    GMappedFile *file = g_mapped_file_new(filename.c_str(), FALSE, &error);
+    if (error != NULL) {
+        Log::Warning("Sequence: cannot read '%s' (%s)", filename.c_str(), error->message);
+        g_clear_error (&error);
+        return frame;
+    }
+
+    // decode image in RGBA
+    int w = 0, h = 0, n = 0;
+    stbi_uc *img = stbi_load_from_memory( (const stbi_uc *) g_mapped_file_get_contents(file),
+                                          (int) g_mapped_file_get_length(file), &w, &h, &n, 4);
+    g_mapped_file_unref(file);
+
+    if (img == nullptr)
+        Log::Warning("Sequence: cannot decode '%s' (%s)", filename.c_str(), stbi_failure_reason());
+    else if ( (guint) w != width || (guint) h != height )
+        Log::Warning("Sequence: image '%s' is %d x %d instead of %d x %d", filename.c_str(), w, h, width, height);
+    else {
+        frame = std::make_shared< std::vector<guint8> >( (size_t) w * h * 4 );
+        memcpy(frame->data(), img, frame->size());
+    }
+
+    if (img)
+        stbi_image_free(img);
+
+    return frame;
+}
+
+void SequenceReader::prefetch()
+{
+    std::map<int, std::shared_future<FrameData> > frames;
+
+    // indices of the next images in order of playback
+    int i = next_;
+    for (guint k = 0; k < prefetch_ && !ended_; ++k) {
+        auto f = frames_.find(i);
+        if ( f != frames_.end() )
+            frames[i] = f->second;
+        else {
+            std::string name = filename(i);
+            guint w = width_;
+            guint h = height_;
+            frames[i] = pool().submit<FrameData>( [name, w, h]() { return decode(name, w, h); }, priority_ ).share();
+        }
+        if (i < end_)
+            ++i;
+        else if (loop_)
+            i = begin_;
+        else
+            break;
+        // range shorter than prefetch
+        if (i == next_)
+            break;
+    }
+
+    // frames not needed are dropped (decoding continues in background if started)
+    frames_.swap(frames);
+}
+
+void SequenceReader::setRange(int begin, int end, bool loop)
+{
+    std::lock_guard<std::mutex> lock(access_);
+
+    begin_ = MAX(begin, 0);
+    end_ = MAX(end, begin_);
+    loop_ = loop;
+
+    // continue playing in the new range
+    if ( next_ < begin_ || next_ > end_ || (ended_ && loop_) ) {
+        next_ = begin_;
+        ended_ = false;
+    }
+    prefetch();
+}
+
+void SequenceReader::setIndex(int index)
+{
+    std::lock_guard<std::mutex> lock(access_);
+
+    next_ = CLAMP(index, begin_, end_);
+    ended_ = false;
+    prefetch();
+}
+
+int SequenceReader::index()
+{
+    std::lock_guard<std::mutex> lock(access_);
+    return current_;
+}
+
+SequenceReader::FrameData SequenceReader::next(GstClockTime *pts, bool *ended)
+{
+    std::shared_future<FrameData> frame;
+    {
+        std::lock_guard<std::mutex> lock(access_);
+
+        *ended = ended_;
+        if (ended_)
+            return nullptr;
+
+        // take frame of next index
+        prefetch();
+        frame = frames_[next_];
+        current_ = next_;
+
+        // advance in range
+        if (next_ < end_)
+            ++next_;
+        else if (loop_)
+            next_ = begin_;
+        else
+            ended_ = true;
+
+        // continuous timestamps (whatever the index)
+        *pts = gst_util_uint64_scale(count_++, GST_SECOND, framerate_);
+
+        // decode following images
+        prefetch();
+    }
+
+    // wait for decoding (if not done already)
+    FrameData data;
+    try {
+        data = frame.get();
+    }
+    catch (const std::future_error &) {
+        data = nullptr;
+    }
+    return data;
+}
+
+void SequenceReader::seek(GstClockTime t)
+{
+    std::lock_guard<std::mutex> lock(access_);
+
+    count_ = gst_util_uint64_scale(t, framerate_, GST_SECOND);
+
+    // restart after end of stream
+    if (ended_) {
+        next_ = begin_;
+        ended_ = false;
+        prefetch();
+    }
+}
+
+///
+/// appsrc reading a SequenceReader
+///
+
+typedef std::shared_ptr<SequenceReader> SequenceReaderPtr;
+
+static void sequence_release_frame(gpointer data)
+{
+    delete (SequenceReader::FrameData *) data;
+}
+
+void SequenceReader::need_data(GstAppSrc *src, guint, gpointer p)
+{
+    SequenceReader *reader = ((SequenceReaderPtr *) p)->get();
+
+    std::lock_guard<std::mutex> lock(reader->push_);
+    reader->pushed_ = true;
+    reader->push_next(src);
+}
+
+void SequenceReader::push_next(GstAppSrc *src)
+{
+    // skip images that cannot be decoded (a few at most)
+    for (int attempt = 0; attempt < SEQUENCE_PREFETCH * 4; ++attempt) {
+
+        bool ended = false;
+        GstClockTime pts = GST_CLOCK_TIME_NONE;
+        SequenceReader::FrameData frame = next(&pts, &ended);
+
+        if (ended) {
+            gst_app_src_end_of_stream (src);
+            return;
+        }
+
+        if (frame) {
+            // no copy: the buffer keeps the frame alive while in use
+            GstBuffer *buf = gst_buffer_new_wrapped_full( GST_MEMORY_FLAG_READONLY, frame->data(), frame->size(), 0,
+                                                          frame->size(), new SequenceReader::FrameData(frame),
+                                                          sequence_release_frame );
+            GST_BUFFER_PTS(buf) = pts;
+            GST_BUFFER_DURATION(buf) = gst_util_uint64_scale(1, GST_SECOND, framerate_);
+            gst_app_src_push_buffer (src, buf);
+            return;
+        }
+    }
+
+    Log::Warning("Sequence: cannot decode images of '%s'", location_.c_str());
+    gst_app_src_end_of_stream (src);
+}
+
+gboolean SequenceReader::seek_data(GstAppSrc *, guint64 t, gpointer p)
+{
+    ((SequenceReaderPtr *) p)->get()->seek(t);
+    return TRUE;
+}
+
+static void sequence_free(gpointer p)
+{
+    delete (SequenceReaderPtr *) p;
+}
+
+void SequenceReader::setup_source(GstElement *source, std::shared_ptr<SequenceReader> reader)
+{
+    if ( !GST_IS_APP_SRC(source) || !reader )
+        return;
+
+    GstAppSrcCallbacks callbacks = {};
+    callbacks.need_data = need_data;
+    callbacks.seek_data = seek_data;
+
+    gst_app_src_set_stream_type (GST_APP_SRC(source), GST_APP_STREAM_TYPE_SEEKABLE);
+    g_object_set (G_OBJECT (source), "format", GST_FORMAT_TIME, NULL);
+    gst_app_src_set_callbacks (GST_APP_SRC(source), &callbacks, new SequenceReaderPtr(reader), sequence_free);
+
+    // the streaming thread waits for a first frame if it asked for data before
+    // the callbacks were set (the pipeline starts pre-rolling when opened):
+    // pushed by a worker, after decoding of the first images queued by setRange
+    // (only if the streaming thread did not ask for data meanwhile)
+    GstAppSrc *src = GST_APP_SRC( gst_object_ref (source) );
+    pool().submit<void>( [src, reader]() {
+        std::lock_guard<std::mutex> lock(reader->push_);
+        if ( !reader->pushed_ ) {
+            reader->pushed_ = true;
+            reader->push_next(src);
+        }
+        gst_object_unref (src);
+    }, reader->priority_ );
+}
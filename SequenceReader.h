@@ -0,0 +1,102 @@
+#ifndef SEQUENCEREADER_H
+#define SEQUENCEREADER_H
+
+#include <memory>
+#include <future>
+#include <mutex>
+#include <vector>
+#include <map>
+#include <string>
+
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+
+#include "WorkerPool.h"
+
+// number of images decoded in advance (per sequence)
+#define SEQUENCE_PREFETCH 8
+
+/**
+ * @brief The SequenceReader class
+ *
+ * Gives the images of a numbered sequence to the appsrc of a MultiFile
+ * pipeline, in order of playback (range and loop). The next images are
+ * decoded in advance by a pool of worker threads, so that reading and
+ * decoding image files (mapped in memory) never happen in the streaming
+ * thread and use several cores.
+ *
+ * Decoded images are kept in a ring of frames ahead of the one playing;
+ * changing the range or the index only drops the frames not needed.
+ */
+class SequenceReader
+{
+public:
+    typedef std::shared_ptr< std::vector<guint8> > FrameData;
+
+    SequenceReader(const std::string &location, guint width, guint height,
+                   guint framerate, guint prefetch = SEQUENCE_PREFETCH);
+    ~SequenceReader();
+    // non assignable class
+    SequenceReader(SequenceReader const&) = delete;
+    SequenceReader& operator=(SequenceReader const&) = delete;
+
+    /**
+     * True if images of this codec (e.g. 'png') can be decoded
+     * */
+    static bool supported(const std::string &codec);
+    /**
+     * Set range of indices and loop mode
+     * */
+    void setRange(int begin, int end, bool loop);
+    /**
+     * Set index of next image to play
+     * */
+    void setIndex(int index);
+    /**
+     * Get index of image playing
+     * */
+    int index();
+    /**
+     * Configure the appsrc to read frames from this reader
+     * (the reader is kept alive by the appsrc)
+     * */
+    static void setup_source(GstElement *source, std::shared_ptr<SequenceReader> reader);
+
+private:
+    // consumer side (streaming thread)
+    FrameData next(GstClockTime *pts, bool *ended);
+    void seek(GstClockTime t);
+    // under lock: decode images following next_ index, drop others
+    void prefetch();
+    // appsrc callbacks
+    static void need_data(GstAppSrc *src, guint length, gpointer p);
+    // under push lock: give the next frame to the appsrc
+    void push_next(GstAppSrc *src);
+    static gboolean seek_data(GstAppSrc *src, guint64 t, gpointer p);
+
+    // worker side
+    static FrameData decode(const std::string &filename, guint width, guint height);
+    std::string filename(int index) const;
+
+    std::string location_;
+    guint width_;
+    guint height_;
+    guint framerate_;
+    guint prefetch_;
+    WorkerPool::Priority priority_;
+
+    std::mutex access_;
+    std::map<int, std::shared_future<FrameData> > frames_;
+    int begin_, end_;
+    bool loop_;
+    int next_;
+    int current_;
+    bool ended_;
+    guint64 count_;
+    std::mutex push_;
+    bool pushed_;
+
+    static WorkerPool &pool();
+};
+
+#endif // SEQUENCEREADER_H
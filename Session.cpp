@@ -10,6 +10,7 @@
 #include "SessionCreator.h"
 #include "SessionSource.h"
 #include "MixingGroup.h"
+#include "TextureUploader.h"
 
 #include "Log.h"
 
@@ -85,9 +86,8 @@ void Session::update(float dt)
     if ( render_.frame() == nullptr )
         return;
 
-    // pre-render of all sources
+    // update of all sources
     failedSource_ = nullptr;
-    bool ready = true;
     for( SourceList::iterator it = sources_.begin(); it != sources_.end(); ++it){
 
         // ensure the RenderSource is rendering this session
@@ -99,12 +99,23 @@ void Session::update(float dt)
             failedSource_ = (*it);
         }
         else {
+            // update the source
+            (*it)->update(dt);
+        }
+    }
+
+    // upload the frames submitted by sources during update, all together
+    // (sources render the frames of this cycle)
+    TextureUploader::flush();
+
+    // pre-render of all sources
+    bool ready = true;
+    for( SourceList::iterator it = sources_.begin(); it != sources_.end(); ++it){
+        if ( !(*it)->failed() ) {
             if ( !(*it)->ready() )
                 ready = false;
             // render the source
             (*it)->render();
-            // update the source
-            (*it)->update(dt);
         }
     }
 
@@ -679,6 +679,15 @@ void SessionLoader::visit(MediaPlayer &n)
             mediaplayerNode->QueryBoolAttribute("software_decoding", &gpudisable);
             n.setSoftwareDecodingForced(gpudisable);
 
+            // (default of the media player if not in the session)
+            bool cache = false;
+            if ( mediaplayerNode->QueryBoolAttribute("frame_cache", &cache) == XML_SUCCESS )
+                n.setCacheEnabled(cache);
+
+            bool memory = false;
+            mediaplayerNode->QueryBoolAttribute("memory_resident", &memory);
+            n.setMemoryEnabled(memory);
+
             bool play = true;
             mediaplayerNode->QueryBoolAttribute("play", &play);
             n.play(play);
@@ -16,6 +16,7 @@
 #include "Session.h"
 #include "SessionCreator.h"
 #include "Mixer.h"
+#include "DecoderThreads.h"
 
 
 SessionSource::SessionSource(uint64_t id) : Source(id), failed_(false), timer_(0), paused_(false)
@@ -156,7 +157,11 @@ void SessionFileSource::load(const std::string &p, uint recursion)
     }
     else {
         // launch a thread to load the session file
-        sessionLoader_ = std::async(std::launch::async, Session::load, path_, recursion);
+        sessionLoader_ = std::async(std::launch::async, [](const std::string &path, uint r) {
+            // run on all cores (not on the core of the render thread if pinned)
+            DecoderThreads::unpinThread();
+            return Session::load(path, r);
+        }, path_, recursion);
         Log::Notify("Opening %s", p.c_str());
     }
 
@@ -238,7 +243,7 @@ void SessionFileSource::render()
 {
     if ( !initialized_ )
         init();
-    else {
+    else if ( !suspended_ ) {
         // render the media player into frame buffer
         renderbuffer_->begin();
         texturesurface_->draw(glm::identity<glm::mat4>(), renderbuffer_->projection());
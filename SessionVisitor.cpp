@@ -327,6 +327,8 @@ void SessionVisitor::visit(MediaPlayer &n)
         newelement->SetAttribute("loop", (int) n.loop());
         newelement->SetAttribute("speed", n.playSpeed());
         newelement->SetAttribute("software_decoding", n.softwareDecodingForced());
+        newelement->SetAttribute("frame_cache", n.cacheEnabled());
+        newelement->SetAttribute("memory_resident", n.memoryEnabled());
 
         // timeline
         XMLElement *timelineelement = xmlDoc_->NewElement("Timeline");
@@ -78,6 +78,7 @@ void Settings::Save()
     widgetsNode->SetAttribute("history", application.widget.history);
     widgetsNode->SetAttribute("media_player", application.widget.media_player);
     widgetsNode->SetAttribute("media_player_view", application.widget.media_player_view);
+    widgetsNode->SetAttribute("media_player_sync", application.widget.media_player_sync);
     widgetsNode->SetAttribute("timeline_editmode", application.widget.timeline_editmode);
     widgetsNode->SetAttribute("shader_editor", application.widget.shader_editor);
     widgetsNode->SetAttribute("stats", application.widget.stats);
@@ -93,6 +94,15 @@ void Settings::Save()
     RenderNode->SetAttribute("multisampling", application.render.multisampling);
     RenderNode->SetAttribute("blit", application.render.blit);
     RenderNode->SetAttribute("gpu_decoding", application.render.gpu_decoding);
+    RenderNode->SetAttribute("native_yuv", application.render.native_yuv);
+    RenderNode->SetAttribute("adaptive_decoding", application.render.adaptive_decoding);
+    RenderNode->SetAttribute("frame_cache_budget", application.render.frame_cache_budget);
+    RenderNode->SetAttribute("media_memory_budget", application.render.media_memory_budget);
+    RenderNode->SetAttribute("image_texture_budget", application.render.image_texture_budget);
+    RenderNode->SetAttribute("decoder_threads", application.render.decoder_threads);
+    RenderNode->SetAttribute("upload_budget", application.render.upload_budget);
+    RenderNode->SetAttribute("render_affinity", application.render.render_affinity);
+    RenderNode->SetAttribute("low_latency_capture", application.render.low_latency_capture);
     RenderNode->SetAttribute("ratio", application.render.ratio);
     RenderNode->SetAttribute("res", application.render.res);
     pRoot->InsertEndChild(RenderNode);
@@ -118,6 +128,7 @@ void Settings::Save()
     SourceConfNode->SetAttribute("new_type", application.source.new_type);
     SourceConfNode->SetAttribute("ratio", application.source.ratio);
     SourceConfNode->SetAttribute("res", application.source.res);
+    SourceConfNode->SetAttribute("inactive_release", application.source.inactive_release);
     pRoot->InsertEndChild(SourceConfNode);
 
     // Brush
@@ -275,6 +286,7 @@ void Settings::Load()
         widgetsNode->QueryBoolAttribute("history", &application.widget.history);
         widgetsNode->QueryBoolAttribute("media_player", &application.widget.media_player);
         widgetsNode->QueryIntAttribute("media_player_view", &application.widget.media_player_view);
+        widgetsNode->QueryBoolAttribute("media_player_sync", &application.widget.media_player_sync);
         widgetsNode->QueryBoolAttribute("timeline_editmode", &application.widget.timeline_editmode);
         widgetsNode->QueryBoolAttribute("shader_editor", &application.widget.shader_editor);
         widgetsNode->QueryBoolAttribute("stats", &application.widget.stats);
@@ -291,6 +303,15 @@ void Settings::Load()
         rendernode->QueryIntAttribute("multisampling", &application.render.multisampling);
         rendernode->QueryBoolAttribute("blit", &application.render.blit);
         rendernode->QueryBoolAttribute("gpu_decoding", &application.render.gpu_decoding);
+        rendernode->QueryBoolAttribute("native_yuv", &application.render.native_yuv);
+        rendernode->QueryBoolAttribute("adaptive_decoding", &application.render.adaptive_decoding);
+        rendernode->QueryIntAttribute("frame_cache_budget", &application.render.frame_cache_budget);
+        rendernode->QueryIntAttribute("media_memory_budget", &application.render.media_memory_budget);
+        rendernode->QueryIntAttribute("image_texture_budget", &application.render.image_texture_budget);
+        rendernode->QueryIntAttribute("decoder_threads", &application.render.decoder_threads);
+        rendernode->QueryIntAttribute("upload_budget", &application.render.upload_budget);
+        rendernode->QueryBoolAttribute("render_affinity", &application.render.render_affinity);
+        rendernode->QueryBoolAttribute("low_latency_capture", &application.render.low_latency_capture);
         rendernode->QueryIntAttribute("ratio", &application.render.ratio);
         rendernode->QueryIntAttribute("res", &application.render.res);
     }
@@ -315,6 +336,7 @@ void Settings::Load()
         sourceconfnode->QueryIntAttribute("new_type", &application.source.new_type);
         sourceconfnode->QueryIntAttribute("ratio", &application.source.ratio);
         sourceconfnode->QueryIntAttribute("res", &application.source.res);
+        sourceconfnode->QueryIntAttribute("inactive_release", &application.source.inactive_release);
     }
 
     // Transition
@@ -25,6 +25,7 @@ struct WidgetsConfig
     int  preview_view;
     bool media_player;
     int  media_player_view;
+    bool media_player_sync;
     bool timeline_editmode;
     bool shader_editor;
     bool toolbox;
@@ -40,6 +41,7 @@ struct WidgetsConfig
         history = false;
         media_player = false;
         media_player_view = -1;
+        media_player_sync = false;
         timeline_editmode = false;
         shader_editor = false;
         toolbox = false;
@@ -132,6 +134,15 @@ struct RenderConfig
     int res;
     float fading;
     bool gpu_decoding;
+    bool native_yuv;
+    bool adaptive_decoding;
+    int frame_cache_budget;
+    int media_memory_budget;
+    int image_texture_budget;
+    int decoder_threads;
+    int upload_budget;
+    bool render_affinity;
+    bool low_latency_capture;
 
     RenderConfig() {
         blit = false;
@@ -141,6 +152,15 @@ struct RenderConfig
         res = 1;
         fading = 0.0;
         gpu_decoding = true;
+        native_yuv = false;
+        adaptive_decoding = false;
+        frame_cache_budget = 1024;
+        media_memory_budget = 4096;
+        image_texture_budget = 1024;
+        decoder_threads = 0;
+        upload_budget = 64;
+        render_affinity = false;
+        low_latency_capture = false;
     }
 };
 
@@ -149,11 +169,13 @@ struct SourceConfig
     int new_type;
     int ratio;
     int res;
+    int inactive_release;
 
     SourceConfig() {
         new_type = 0;
         ratio = 3;
         res = 1;
+        inactive_release = 0;
     }
 };
 
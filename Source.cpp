@@ -14,6 +14,7 @@
 #include "BaseToolkit.h"
 #include "SystemToolkit.h"
 #include "Log.h"
+#include "Settings.h"
 #include "MixingGroup.h"
 
 #include "Source.h"
@@ -284,6 +285,11 @@ Source::Source(uint64_t id) : SourceCore(), id_(id), ready_(false), symbol_(null
     maskbuffer_     = nullptr;
     maskimage_      = nullptr;
     mask_need_update_ = false;
+
+    // not suspended
+    suspended_      = false;
+    inactive_time_  = 0.f;
+    thumbnail_      = nullptr;
 }
 
 
@@ -305,6 +311,8 @@ Source::~Source()
         delete maskbuffer_;
     if (maskimage_)
         delete maskimage_;
+    if (thumbnail_)
+        delete thumbnail_;
     if (masksurface_)
         delete masksurface_; // deletes maskshader_
 
@@ -416,7 +424,7 @@ void Source::render()
 {
     if ( renderbuffer_ == nullptr )
         init();
-    else {
+    else if ( !suspended_ ) {
         // render the view into frame buffer
         renderbuffer_->begin();
         texturesurface_->draw(glm::identity<glm::mat4>(), renderbuffer_->projection());
@@ -512,6 +520,67 @@ void Source::setActive (bool on)
     groups_[View::LAYER]->visible_ = active_;
 }
 
+float Source::priority () const
+{
+    if ( !active_ )
+        return 0.f;
+
+    if ( mode_ == Source::CURRENT )
+        return 2.f;
+
+    return alpha();
+}
+
+void Source::suspend ()
+{
+    if ( suspended_ || renderbuffer_ == nullptr )
+        return;
+
+    // keep a small copy of the last frame rendered
+    if ( thumbnail_ == nullptr || thumbnail_->aspectRatio() != renderbuffer_->aspectRatio() ) {
+        if (thumbnail_)
+            delete thumbnail_;
+        thumbnail_ = new FrameBuffer( glm::vec3(SOURCE_THUMBNAIL_HEIGHT * renderbuffer_->aspectRatio(), SOURCE_THUMBNAIL_HEIGHT, 1.f),
+                                      renderbuffer_->use_alpha() );
+    }
+    if ( !renderbuffer_->blit(thumbnail_) ) {
+        FrameBufferSurface *thumb = new FrameBufferSurface(renderbuffer_);
+        thumbnail_->begin();
+        thumb->draw(glm::identity<glm::mat4>(), thumbnail_->projection());
+        thumbnail_->end();
+        delete thumb;
+    }
+
+    // display the thumbnail instead of the frame buffer
+    rendersurface_->setFrameBuffer(thumbnail_);
+    mixingsurface_->setFrameBuffer(thumbnail_);
+
+    // keep the mask in RAM (unless already there)
+    if ( !mask_need_update_ )
+        storeMask();
+
+    // free GPU memory of frame buffers
+    renderbuffer_->discard();
+    maskbuffer_->discard();
+
+    suspended_ = true;
+}
+
+void Source::resume ()
+{
+    if ( !suspended_ )
+        return;
+
+    suspended_ = false;
+
+    // the thumbnail is displayed until the frame buffer is rendered again
+    ready_ = false;
+
+    // restore the mask from RAM
+    mask_need_update_ = maskimage_ != nullptr;
+    touch();
+}
+
 void Source::setLocked (bool on)
 {
     locked_ = on;
@@ -583,6 +652,30 @@ void Source::update(float dt)
     // keep delta-t
     dt_ = dt;
 
+    // release resources of a source left inactive in limbo for a while,
+    // and restore them before it comes back (or if it is selected)
+    if (renderbuffer_ && mixingsurface_) {
+        bool nearby = active_ || mode_ == Source::CURRENT ||
+                glm::length( glm::vec2(groups_[View::MIXING]->translation_) ) < MIXING_LIMBO_WAKEUP;
+        // active clones display the frames of this source
+        for (auto c = clones_.begin(); !nearby && c != clones_.end(); ++c)
+            nearby = (*c)->active_ || (*c)->mode_ == Source::CURRENT;
+        inactive_time_ = nearby ? 0.f : inactive_time_ + dt;
+
+        if (suspended_) {
+            if (nearby)
+                resume();
+        }
+        else if ( Settings::application.source.inactive_release > 0 &&
+                  inactive_time_ > Settings::application.source.inactive_release * 1000.f )
+            suspend();
+        // rendered again since resumed: display the frame buffer
+        else if ( ready_ && mixingsurface_->getFrameBuffer() != renderbuffer_ ) {
+            rendersurface_->setFrameBuffer(renderbuffer_);
+            mixingsurface_->setFrameBuffer(renderbuffer_);
+        }
+    }
+
     // update nodes if needed
     if (renderbuffer_ && mixingsurface_ && maskbuffer_ && need_update_)
     {
@@ -667,12 +760,12 @@ void Source::update(float dt)
 
         // if a mask image was given to be updated
         if (mask_need_update_) {
-            // fill the mask buffer (once)
-            if (maskbuffer_->fill(maskimage_) )
+            // fill the mask buffer (once, not while suspended)
+            if ( !suspended_ && maskbuffer_->fill(maskimage_) )
                 mask_need_update_ = false;
         }
-        // otherwise, render the mask buffer
-        else
+        // otherwise, render the mask buffer (not while suspended)
+        else if ( !suspended_ )
         {
             // draw mask in mask frame buffer
             maskbuffer_->begin(false);
@@ -858,6 +951,15 @@ void CloneSource::init()
     }
 }
 
+void CloneSource::render()
+{
+    // texture of origin can change (e.g. re-created when it resumes)
+    if ( renderbuffer_ != nullptr && origin_ != nullptr )
+        texturesurface_->setTextureIndex( origin_->texture() );
+
+    Source::render();
+}
+
 void CloneSource::setActive (bool on)
 {
     active_ = on;
@@ -127,6 +127,16 @@ public:
     inline  bool active () const { return active_; }
     virtual void setActive (bool on);
 
+    // importance of the frames of the source in output (current source
+    // first, then by alpha), e.g. to order uploads of textures
+    float priority () const;
+
+    // resources of a source left inactive can be released (a thumbnail
+    // is displayed meanwhile) and restored when it comes back
+    virtual void suspend ();
+    virtual void resume ();
+    inline  bool suspended () const { return suspended_; }
+
     // lock mode
     inline  bool locked () const { return locked_; }
     virtual void setLocked (bool on);
@@ -284,6 +294,11 @@ protected:
     float dt_;
     Workspace  workspace_;
 
+    // suspend
+    bool  suspended_;
+    float inactive_time_;
+    FrameBuffer *thumbnail_;
+
     // clones
     CloneList clones_;
 
@@ -305,6 +320,7 @@ public:
     ~CloneSource();
 
     // implementation of source API
+    void render () override;
     void setActive (bool on) override;
     bool playing () const override { return true; }
     void play (bool) override {}
@@ -1,10 +1,13 @@
 #include <thread>
+#include <vector>
+#include <algorithm>
 
 using namespace std;
 
 //  Desktop OpenGL function loader
 #include <glad/glad.h>
 
+#include <glm/gtc/matrix_transform.hpp>
 
 // vmix
 #include "defines.h"
@@ -13,6 +16,11 @@ using namespace std;
 #include "Visitor.h"
 #include "SystemToolkit.h"
 #include "BaseToolkit.h"
+#include "FrameBuffer.h"
+#include "Primitives.h"
+#include "ImageShader.h"
+#include "JpegDecoder.h"
+#include "DecoderThreads.h"
 
 #include "Stream.h"
 
@@ -21,12 +29,13 @@ using namespace std;
 #endif
 
 
-Stream::Stream()
+Stream::Stream() : frame_queue_(N_FRAME)
 {
     // create unique id
     id_ = BaseToolkit::uniqueId();
 
     description_ = "undefined";
+    format_ = RGBA;
     pipeline_ = nullptr;
     opened_ = false;
     enabled_ = true;
@@ -37,34 +46,33 @@ Stream::Stream()
     height_ = -1;
     single_frame_ = false;
     live_ = false;
+    low_latency_ = false;
     failed_ = false;
-
-    // start index in frame_ stack
-    write_index_ = 0;
-    last_index_ = 0;
-
-    // no PBO by default
-    pbo_[0] = pbo_[1] = 0;
-    pbo_size_ = 0;
-    pbo_index_ = 0;
-    pbo_next_index_ = 0;
+    updated_arrival_ = GST_CLOCK_TIME_NONE;
+    updated_capture_ = GST_CLOCK_TIME_NONE;
 
     // OpenGL texture
     textureindex_ = 0;
     textureinitialized_ = false;
+    yuv_textures_[0] = yuv_textures_[1] = 0;
+    yuv_buffer_ = nullptr;
+    yuv_surface_ = nullptr;
+    jpeg_ = nullptr;
 }
 
 Stream::~Stream()
 {
     close();
 
+    // cleanup picture buffer
+    uploader_.reset();
+
     // cleanup opengl texture
     if (textureindex_)
         glDeleteTextures(1, &textureindex_);
 
-    // cleanup picture buffer
-    if (pbo_[0])
-        glDeleteBuffers(2, pbo_);
+    // cleanup YUV planes and conversion
+    release_planes();
 }
 
 void Stream::accept(Visitor& v) {
@@ -76,13 +84,17 @@ guint Stream::texture() const
     if (textureindex_ == 0)
         return Resource::getTextureBlack();
 
+    // YUV planes are converted into the RGB frame buffer
+    if (yuv_buffer_)
+        return yuv_buffer_->texture();
+
     return textureindex_;
 }
 
 
-void Stream::open(const std::string &gstreamer_description, guint w, guint h)
+void Stream::open(const std::string &gstreamer_description, guint w, guint h, Format format)
 {
-    if (w != width_ || h != height_ )
+    if (w != width_ || h != height_ || format != format_)
         textureinitialized_ = false;
 
     // set gstreamer pipeline source
@@ -94,6 +106,8 @@ void Stream::open(const std::string &gstreamer_description, guint w, guint h)
     if (isOpen())
         close();
 
+    format_ = format;
+
     // open the stream
     execute_open();
 }
@@ -125,9 +139,14 @@ void Stream::execute_open()
     g_object_set(G_OBJECT(pipeline_), "name", std::to_string(id_).c_str(), NULL);
     gst_pipeline_set_auto_flush_bus( GST_PIPELINE(pipeline_), true);
 
-    // GstCaps *caps = gst_static_caps_get (&frame_render_caps);
-    string capstring = "video/x-raw,format=RGBA,width="+ std::to_string(width_) +
-            ",height=" + std::to_string(height_);
+    // decoders share the budget of threads, and streaming
+    // threads run on all cores (if render thread is pinned)
+    DecoderThreads::setup(pipeline_);
+
+    // frames are given in native format (RGBA for JPEG decoded images)
+    static const char *formats[5] = { "RGBA", "I420", "NV12", "YUY2", "RGBA" };
+    string size = ",width="+ std::to_string(width_) + ",height=" + std::to_string(height_);
+    string capstring = "video/x-raw,format=" + string(formats[format_]) + size;
     GstCaps *caps = gst_caps_from_string(capstring.c_str());
     if (!caps || !gst_video_info_from_caps (&v_frame_video_info_, caps)) {
         Log::Warning("Stream %d Could not configure video frame info", id_);
@@ -135,6 +154,16 @@ void Stream::execute_open()
         return;
     }
 
+    // JPEG images are taken by the sink to be decoded by the stream
+    if (format_ == JPEG) {
+        gst_caps_unref (caps);
+        capstring = "image/jpeg" + size;
+        caps = gst_caps_from_string(capstring.c_str());
+        if (jpeg_)
+            delete jpeg_;
+        jpeg_ = new JpegDecoder(width_, height_);
+    }
+
     // setup appsink
     GstElement *sink = gst_bin_get_by_name (GST_BIN (pipeline_), "sink");
     if (!sink) {
@@ -147,7 +176,8 @@ void Stream::execute_open()
     gst_app_sink_set_caps (GST_APP_SINK(sink), caps);
 
     // Instruct appsink to drop old buffers when the maximum amount of queued buffers is reached.
-    gst_app_sink_set_max_buffers( GST_APP_SINK(sink), 30);
+    // (in low latency, keep only the newest buffer)
+    gst_app_sink_set_max_buffers( GST_APP_SINK(sink), low_latency_ ? 1 : 30);
     gst_app_sink_set_drop (GST_APP_SINK(sink), true);
 
 #ifdef USE_GST_APPSINK_CALLBACKS
@@ -189,7 +219,8 @@ void Stream::execute_open()
     }
 
     // instruct the sink to send samples synched in time if not live source
-    gst_base_sink_set_sync (GST_BASE_SINK(sink), !live_);
+    // (in low latency, send samples as soon as received)
+    gst_base_sink_set_sync (GST_BASE_SINK(sink), !live_ && !low_latency_);
 
     // done with refs
     gst_object_unref (sink);
@@ -243,14 +274,17 @@ void Stream::close()
         pipeline_ = nullptr;
     }
 
+    // drop JPEG images being decoded
+    if (jpeg_ != nullptr) {
+        delete jpeg_;
+        jpeg_ = nullptr;
+    }
+
     // cleanup eventual remaining frame memory
-    for(guint i = 0; i < N_FRAME; ++i){
-        frame_[i].access.lock();
+    for(guint i = 0; i < N_FRAME; ++i)
         frame_[i].unmap();
-        frame_[i].access.unlock();
-    }
-    write_index_ = 0;
-    last_index_ = 0;
+    frame_queue_.reset();
+    updated_arrival_ = GST_CLOCK_TIME_NONE;
 
 }
 
@@ -272,13 +306,17 @@ float Stream::aspectRatio() const
 
 void Stream::enable(bool on)
 {
-    if ( !opened_ || pipeline_ == nullptr)
+    if ( !opened_ )
         return;
 
     if ( enabled_ != on ) {
 
         enabled_ = on;
 
+        // nothing else to do without pipeline (e.g. generated on GPU)
+        if ( pipeline_ == nullptr )
+            return;
+
         // default to pause
         GstState requested_state = GST_STATE_PAUSED;
 
@@ -390,7 +428,16 @@ GstClockTime Stream::position()
 
 void Stream::init_texture(guint index)
 {
+    // YUV frames are uploaded as planes
+    if (format_ == I420 || format_ == NV12 || format_ == YUY2) {
+        init_planes(index);
+        textureinitialized_ = true;
+        return;
+    }
+
+    release_planes();
     glActiveTexture(GL_TEXTURE0);
+    uploader_.reset();
     if (textureindex_)
         glDeleteTextures(1, &textureindex_);
     glGenTextures(1, &textureindex_);
@@ -402,49 +449,6 @@ void Stream::init_texture(guint index)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    if (!single_frame_) {
-
-        // set pbo image size
-        pbo_size_ = height_ * width_ * 4;
-
-        // create pixel buffer objects,
-        if (pbo_[0])
-            glDeleteBuffers(2, pbo_);
-        glGenBuffers(2, pbo_);
-
-        for(int i = 0; i < 2; i++ ) {
-            // create 2 PBOs
-            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_[i]);
-            // glBufferDataARB with NULL pointer reserves only memory space.
-            glBufferData(GL_PIXEL_UNPACK_BUFFER, pbo_size_, 0, GL_STREAM_DRAW);
-            // fill in with reset picture
-            GLubyte* ptr = (GLubyte*) glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
-            if (ptr)  {
-                // update data directly on the mapped buffer
-                memmove(ptr, frame_[index].vframe.data[0], pbo_size_);
-                // release pointer to mapping buffer
-                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-            }
-            else {
-                // did not work, disable PBO
-                glDeleteBuffers(2, pbo_);
-                pbo_[0] = pbo_[1] = 0;
-                pbo_size_ = 0;
-                break;
-            }
-
-        }
-
-        // should be good to go, wrap it up
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-        pbo_index_ = 0;
-        pbo_next_index_ = 1;
-
-#ifdef STREAM_DEBUG
-        Log::Info("Stream %s Use Pixel Buffer Object texturing.", std::to_string(id_).c_str());
-#endif
-    }
     glBindTexture(GL_TEXTURE_2D, 0);
 
     textureinitialized_ = true;
@@ -456,48 +460,157 @@ void Stream::fill_texture(guint index)
     // is this the first frame ?
     if ( !textureinitialized_ || textureindex_ < 1)
     {
-        // initialize texture
+        // initialize texture (filled with the frame)
         init_texture(index);
     }
-
-    glBindTexture(GL_TEXTURE_2D, textureindex_);
-
-    // use dual Pixel Buffer Object
-    if (pbo_size_ > 0) {
-        // In dual PBO mode, increment current index first then get the next index
-        pbo_index_ = (pbo_index_ + 1) % 2;
-        pbo_next_index_ = (pbo_index_ + 1) % 2;
-
-        // bind PBO to read pixels
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_[pbo_index_]);
-        // copy pixels from PBO to texture object
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, 0);
-        // bind the next PBO to write pixels
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_[pbo_next_index_]);
-        // See http://www.songho.ca/opengl/gl_pbo.html#map for more details
-        glBufferData(GL_PIXEL_UNPACK_BUFFER, pbo_size_, 0, GL_STREAM_DRAW);
-        // map the buffer object into client's memory
-        GLubyte* ptr = (GLubyte*) glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
-        if (ptr) {
-            // update data directly on the mapped buffer
-            // NB : equivalent but faster (memmove instead of memcpy ?) than
-            // glNamedBufferSubData(pboIds[nextIndex], 0, imgsize, vp->getBuffer())
-            memmove(ptr, frame_[index].vframe.data[0], pbo_size_);
-
-            // release pointer to mapping buffer
-            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-        }
-        // done with PBO
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    // YUV frames are uploaded as planes
+    else if (yuv_buffer_) {
+        fill_planes(index);
+    }
+    // upload frames through PBO (batched after update of all sources)
+    else if (!single_frame_ && !low_latency_) {
+        uploader_.submit(textureindex_, (guint8 *) frame_[index].vframe.data[0], width_, height_);
     }
     else {
         // without PBO, use standard opengl (slower)
+        // (in low latency, the frame is in the texture when rendered next)
+        glBindTexture(GL_TEXTURE_2D, textureindex_);
         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_, height_,
                         GL_RGBA, GL_UNSIGNED_BYTE, frame_[index].vframe.data[0]);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+// texture of a plane of YUV frame (two pixels per RGBA texel for packed format)
+static void plane_texture(const GstVideoInfo *info, guint p, GLenum *internal, GLenum *format, guint *w, guint *h)
+{
+    *w = GST_VIDEO_INFO_COMP_WIDTH(info, p);
+    *h = GST_VIDEO_INFO_COMP_HEIGHT(info, p);
+    *internal = GL_R8;
+    *format = GL_RED;
+
+    if ( GST_VIDEO_INFO_FORMAT(info) == GST_VIDEO_FORMAT_YUY2 ) {
+        *w = (*w + 1) / 2;
+        *internal = GL_RGBA8;
+        *format = GL_RGBA;
     }
+    else if ( GST_VIDEO_INFO_FORMAT(info) == GST_VIDEO_FORMAT_NV12 && p > 0 ) {
+        *internal = GL_RG8;
+        *format = GL_RG;
+    }
+}
+
+void Stream::init_planes(guint index)
+{
+    uploader_.reset();
+    if (textureindex_)
+        glDeleteTextures(1, &textureindex_);
+    release_planes();
 
+    // create one texture per plane
+    guint n = GST_VIDEO_INFO_N_PLANES(&v_frame_video_info_);
+    glActiveTexture(GL_TEXTURE0);
+    glGenTextures(1, &textureindex_);
+    if (n > 1)
+        glGenTextures(n - 1, yuv_textures_);
+    for (guint p = 0; p < n; ++p) {
+        GLenum internal, format;
+        guint w, h;
+        plane_texture(&v_frame_video_info_, p, &internal, &format, &w, &h);
+        glBindTexture(GL_TEXTURE_2D, p > 0 ? yuv_textures_[p-1] : textureindex_);
+        glTexStorage2D(GL_TEXTURE_2D, 1, internal, w, h);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
     glBindTexture(GL_TEXTURE_2D, 0);
 
+    // get color matrix and range actually negotiated with the source
+    YUVShader *shader = new YUVShader;
+    GstElement *sink = gst_bin_get_by_name (GST_BIN (pipeline_), "sink");
+    if (sink) {
+        GstPad *pad = gst_element_get_static_pad (sink, "sink");
+        GstCaps *caps = pad ? gst_pad_get_current_caps (pad) : NULL;
+        GstVideoInfo info;
+        if (caps && gst_video_info_from_caps (&info, caps)) {
+            gdouble Kr = 0.0, Kb = 0.0;
+            if ( gst_video_color_matrix_get_Kr_Kb (info.colorimetry.matrix, &Kr, &Kb) )
+                shader->coefficients = glm::vec2(Kr, Kb);
+            shader->fullrange = info.colorimetry.range == GST_VIDEO_COLOR_RANGE_0_255;
+        }
+        if (caps)
+            gst_caps_unref (caps);
+        if (pad)
+            gst_object_unref (pad);
+        gst_object_unref (sink);
+    }
+
+    // surface drawing the planes converted to RGB into the frame buffer
+    if (format_ == NV12)
+        shader->layout = YUVShader::SEMI_PLANAR;
+    else if (format_ == YUY2)
+        shader->layout = YUVShader::PACKED;
+    shader->u_texture = yuv_textures_[0];
+    shader->v_texture = yuv_textures_[1];
+    yuv_surface_ = new Surface(shader);
+    yuv_surface_->setTextureIndex(textureindex_);
+    yuv_buffer_ = new FrameBuffer(width_, height_);
+
+#ifdef STREAM_DEBUG
+    Log::Info("Stream %s uses OpenGL YUV texturing.", std::to_string(id_).c_str());
+#endif
+
+    // planes are converted to RGB each time they are uploaded
+    uploader_.setCallback( std::bind(&Stream::convert_planes, this) );
+
+    // fill planes with first frame
+    fill_planes(index);
+}
+
+void Stream::fill_planes(guint index)
+{
+    GstVideoFrame *frame = &frame_[index].vframe;
+
+    // upload planes of the mapped gst frame through PBO (batched after update of all sources)
+    TextureUploader::Plane planes[TEXTUREUPLOADER_PLANES];
+    guint n = MIN( GST_VIDEO_FRAME_N_PLANES(frame), TEXTUREUPLOADER_PLANES );
+    for (guint p = 0; p < n; ++p) {
+        GLenum internal, format;
+        guint w, h;
+        plane_texture(&v_frame_video_info_, p, &internal, &format, &w, &h);
+        planes[p].texture = p > 0 ? yuv_textures_[p-1] : textureindex_;
+        planes[p].width   = w;
+        planes[p].height  = h;
+        planes[p].format  = format;
+        planes[p].stride  = GST_VIDEO_FRAME_PLANE_STRIDE(frame, p);
+        planes[p].data    = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA(frame, p);
+        planes[p].offset  = 0;
+    }
+    uploader_.submit(planes, n);
+}
+
+void Stream::convert_planes()
+{
+    // convert to RGB
+    yuv_buffer_->begin(false);
+    yuv_surface_->draw(glm::identity<glm::mat4>(), yuv_buffer_->projection());
+    yuv_buffer_->end();
+}
+
+void Stream::release_planes()
+{
+    uploader_.setCallback(nullptr);
+
+    if (yuv_textures_[0])
+        glDeleteTextures(yuv_textures_[1] ? 2 : 1, yuv_textures_);
+    yuv_textures_[0] = yuv_textures_[1] = 0;
+    if (yuv_surface_)
+        delete yuv_surface_;
+    yuv_surface_ = nullptr;
+    if (yuv_buffer_)
+        delete yuv_buffer_;
+    yuv_buffer_ = nullptr;
 }
 
 void Stream::update()
@@ -517,33 +630,18 @@ void Stream::update()
         return;
 
     // local variables before trying to update
-    guint read_index = 0;
     bool need_loop = false;
 
-    // locked access to current index
-    index_lock_.lock();
-    // get the last frame filled from fill_frame()
-    read_index = last_index_;
-    // Do NOT miss and jump directly to a pre-roll
-    for (guint i = 0; i < N_FRAME; ++i) {
-        if (frame_[i].status == PREROLL) {
-            read_index = i;
-            break;
-        }
-    }
-    // unlock access to index change
-    index_lock_.unlock();
-
-    // lock frame while reading it
-    frame_[read_index].access.lock();
+    // get the last frame filled from fill_frame() (if any new)
+    int read_index = frame_queue_.read();
 
     // do not fill a frame twice
-    if (frame_[read_index].status != INVALID ) {
+    if (read_index > -1 && frame_[read_index].status != INVALID ) {
 
         // is this an End-of-Stream frame ?
         if (frame_[read_index].status == EOS )
         {
-            // will execute seek command below (after unlock)
+            // will execute seek command below (after release)
             need_loop = true;
         }
         // otherwise just fill non-empty SAMPLE or PREROLL
@@ -552,9 +650,13 @@ void Stream::update()
             // fill the texture with the frame at reading index
             fill_texture(read_index);
 
-            // double update for pre-roll frame and dual PBO (ensure frame is displayed now)
-            if (frame_[read_index].status == PREROLL && pbo_size_ > 0)
-                fill_texture(read_index);
+            // pre-roll frame is uploaded now (ensure frame is displayed now)
+            if (frame_[read_index].status == PREROLL)
+                uploader_.upload();
+
+            // latency is measured when this frame is rendered
+            updated_arrival_ = frame_[read_index].arrival;
+            updated_capture_ = frame_[read_index].capture;
 
             // free frame
             frame_[read_index].unmap();
@@ -567,8 +669,8 @@ void Stream::update()
         frame_[read_index].status = INVALID;
     }
 
-    // unkock frame after reading it
-    frame_[read_index].access.unlock();
+    // give back frame after reading it
+    frame_queue_.release();
 
     if (need_loop) {
         // stop on end of stream
@@ -581,6 +683,53 @@ double Stream::updateFrameRate() const
     return timecount_.frameRate();
 }
 
+void Stream::rendered()
+{
+    // no new frame since last render, or not uploaded yet (deferred)
+    if (updated_arrival_ == GST_CLOCK_TIME_NONE || uploader_.pending())
+        return;
+
+    LatencySample sample;
+    sample.render = gst_util_get_timestamp();
+    sample.arrival = (double) GST_CLOCK_DIFF(updated_arrival_, sample.render) / (double) GST_MSECOND;
+    sample.capture = -1.0;
+    if (updated_capture_ != GST_CLOCK_TIME_NONE)
+        sample.capture = (double) GST_CLOCK_DIFF(updated_capture_, sample.render) / (double) GST_MSECOND;
+
+    latency_.push_back(sample);
+    if (latency_.size() > STREAM_LATENCY_SAMPLES)
+        latency_.pop_front();
+
+    updated_arrival_ = GST_CLOCK_TIME_NONE;
+}
+
+double Stream::latency(double percentile, bool capture) const
+{
+    std::vector<double> values;
+    for (auto s = latency_.begin(); s != latency_.end(); ++s) {
+        double v = capture ? s->capture : s->arrival;
+        if (v > -1.0)
+            values.push_back(v);
+    }
+    if (values.empty())
+        return -1.0;
+
+    // value at rank of percentile
+    size_t n = (size_t) ( CLAMP(percentile, 0.0, 1.0) * (double) (values.size() - 1) + 0.5 );
+    std::nth_element(values.begin(), values.begin() + n, values.end());
+    return values[n];
+}
+
+void Stream::writeLatency(std::ostream &out, const std::string &label) const
+{
+    for (auto s = latency_.begin(); s != latency_.end(); ++s) {
+        out << "\"" << label << "\"," << s->render / GST_USECOND << "," << s->arrival << ",";
+        if (s->capture > -1.0)
+            out << s->capture;
+        out << "\n";
+    }
+}
+
 
 // CALLBACKS
 
@@ -588,40 +737,53 @@ bool Stream::fill_frame(GstBuffer *buf, FrameStatus status)
 {
 //    Log::Info("Stream fill frame");
 
-    // Do NOT overwrite an unread EOS
-    if ( frame_[write_index_].status == EOS )
-        write_index_ = (write_index_ + 1) % N_FRAME;
-
-    // lock access to frame
-    frame_[write_index_].access.lock();
+    // get a frame to fill (never waits for update)
+    int write_index = frame_queue_.write();
+    if (write_index < 0)
+        return true;
 
     // always empty frame before filling it again
-    frame_[write_index_].unmap();
+    frame_[write_index].unmap();
 
     // accept status of frame received
-    frame_[write_index_].status = status;
+    frame_[write_index].status = status;
 
     // a buffer is given (not EOS)
     if (buf != NULL) {
         // get the frame from buffer
-        if ( !gst_video_frame_map (&frame_[write_index_].vframe, &v_frame_video_info_, buf, GST_MAP_READ ) )
+        if ( !gst_video_frame_map (&frame_[write_index].vframe, &v_frame_video_info_, buf, GST_MAP_READ ) )
         {
             Log::Info("Stream %s Failed to map the video buffer", std::to_string(id_).c_str());
             // free access to frame & exit
-            frame_[write_index_].status = INVALID;
-            frame_[write_index_].access.unlock();
+            frame_[write_index].status = INVALID;
+            frame_queue_.cancel();
             return false;
         }
 
         // successfully filled the frame
-        frame_[write_index_].full = true;
+        frame_[write_index].full = true;
 
         // validate frame format
-        if( GST_VIDEO_INFO_IS_RGB(&(frame_[write_index_].vframe).info) && GST_VIDEO_INFO_N_PLANES(&(frame_[write_index_].vframe).info) == 1)
+        const GstVideoInfo *info = &(frame_[write_index].vframe).info;
+        if( ( GST_VIDEO_INFO_IS_RGB(info) && GST_VIDEO_INFO_N_PLANES(info) == 1 ) ||
+            ( GST_VIDEO_INFO_IS_YUV(info) && GST_VIDEO_INFO_FORMAT(info) == GST_VIDEO_INFO_FORMAT(&v_frame_video_info_) ) )
         {
             // set presentation time stamp
-            frame_[write_index_].position = buf->pts;
-
+            frame_[write_index].position = buf->pts;
+
+            // time of arrival, and estimated time of capture for live streams
+            // (pts is the running time of capture on the pipeline clock)
+            frame_[write_index].arrival = gst_util_get_timestamp();
+            frame_[write_index].capture = GST_CLOCK_TIME_NONE;
+            if ( live_ && GST_BUFFER_PTS_IS_VALID(buf) ) {
+                GstClock *clock = gst_element_get_clock(pipeline_);
+                if (clock) {
+                    GstClockTimeDiff delay = GST_CLOCK_DIFF( gst_element_get_base_time(pipeline_) + buf->pts,
+                                                             gst_clock_get_time(clock) );
+                    frame_[write_index].capture = frame_[write_index].arrival - MAX(delay, 0);
+                    gst_object_unref (clock);
+                }
+            }
         }
         // full but invalid frame : will be deleted next iteration
         // (should never happen)
@@ -629,30 +791,21 @@ bool Stream::fill_frame(GstBuffer *buf, FrameStatus status)
 #ifdef STREAM_DEBUG
             Log::Info("Stream %s Received an Invalid frame", std::to_string(id_).c_str());
 #endif
-            frame_[write_index_].status = INVALID;            
-            frame_[write_index_].access.unlock();
+            frame_[write_index].status = INVALID;
+            frame_queue_.cancel();
             return false;
         }
     }
     // else; null buffer for EOS: give a position
     else {
-        frame_[write_index_].status = EOS;
+        frame_[write_index].status = EOS;
 #ifdef STREAM_DEBUG
         Log::Info("Stream %s Reached End Of Stream", std::to_string(id_).c_str());
 #endif
     }
 
-    // unlock access to frame
-    frame_[write_index_].access.unlock();
-
-    // lock access to change current index (very quick)
-    index_lock_.lock();
-    // indicate update() that this is the last frame filled (and unlocked)
-    last_index_ = write_index_;
-    // unlock access to index change
-    index_lock_.unlock();
-    // for writing, we will access the next in stack
-    write_index_ = (write_index_ + 1) % N_FRAME;
+    // indicate update() that this is the last frame filled
+    frame_queue_.publish();
 
     // calculate actual FPS of update
     timecount_.tic();
@@ -684,8 +837,17 @@ GstFlowReturn Stream::callback_new_preroll (GstAppSink *sink, gpointer p)
             // get buffer from sample
             GstBuffer *buf = gst_sample_get_buffer (sample);
 
+            // decode JPEG image now
+            if (m->jpeg_) {
+                m->jpeg_->push(buf);
+                buf = m->jpeg_->pop(true);
+                if ( buf != NULL && !m->fill_frame(buf, Stream::PREROLL) )
+                    ret = GST_FLOW_ERROR;
+                if ( buf != NULL )
+                    gst_buffer_unref (buf);
+            }
             // fill frame from buffer
-            if ( !m->fill_frame(buf, Stream::PREROLL) )
+            else if ( !m->fill_frame(buf, Stream::PREROLL) )
                 ret = GST_FLOW_ERROR;
         }
     }
@@ -718,8 +880,17 @@ GstFlowReturn Stream::callback_new_sample (GstAppSink *sink, gpointer p)
             // get buffer from sample (valid until sample is released)
             GstBuffer *buf = gst_sample_get_buffer (sample) ;
 
+            // JPEG image is decoded in parallel: fill frames with images decoded
+            if (m->jpeg_) {
+                m->jpeg_->push(buf);
+                while ( (buf = m->jpeg_->pop()) != NULL ) {
+                    if ( !m->fill_frame(buf, Stream::SAMPLE) )
+                        ret = GST_FLOW_ERROR;
+                    gst_buffer_unref (buf);
+                }
+            }
             // fill frame with buffer
-            if ( !m->fill_frame(buf, Stream::SAMPLE) )
+            else if ( !m->fill_frame(buf, Stream::SAMPLE) )
                 ret = GST_FLOW_ERROR;
         }
     }
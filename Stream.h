@@ -2,6 +2,8 @@
 #define STREAM_H
 
 #include <string>
+#include <deque>
+#include <ostream>
 #include <atomic>
 #include <mutex>
 #include <future>
@@ -10,10 +12,18 @@
 #include <gst/pbutils/pbutils.h>
 #include <gst/app/gstappsink.h>
 
+#include "FrameQueue.h"
+#include "TextureUploader.h"
+
 // Forward declare classes referenced
 class Visitor;
+class FrameBuffer;
+class Surface;
+class JpegDecoder;
 
 #define N_FRAME 3
+// number of frames measured for latency
+#define STREAM_LATENCY_SAMPLES 1000
 
 class Stream {
 
@@ -30,10 +40,34 @@ public:
      * Get unique id
      */
     inline uint64_t id() const { return id_; }
+    /**
+     * Format of frames given by the pipeline:
+     * RGBA is uploaded as is, YUV formats are uploaded as planes
+     * and converted on GPU, JPEG images are decoded in parallel
+     * */
+    typedef enum {
+        RGBA = 0,
+        I420,
+        NV12,
+        YUY2,
+        JPEG
+    } Format;
     /**
      * Open a media using gstreamer pipeline keyword
      * */
-    void open(const std::string &gstreamer_description, guint w = 1024, guint h = 576);
+    void open(const std::string &gstreamer_description, guint w = 1024, guint h = 576, Format format = RGBA);
+    /**
+     * Get format of frames
+     * */
+    inline Format format() const { return format_; }
+    /**
+     * Low latency mode (e.g. live capture): frames are not queued
+     * by the sink nor synched on the clock, newest frame wins, and
+     * frames are uploaded at once (not batched by the TextureUploader)
+     * Applies at next open
+     * */
+    inline void setLowLatency(bool on) { low_latency_ = on; }
+    inline bool lowLatency() const { return low_latency_; }
     /**
      * Get description string
      * */
@@ -96,6 +130,11 @@ public:
      * measured during play
      * */
     double updateFrameRate() const;
+    /**
+     * Get number of decoded frames never displayed
+     * (rendering slower than decoding)
+     * */
+    inline uint64_t droppedFrames() const { return frame_queue_.numDropped(); }
     /**
      * Get frame width
      * */
@@ -109,11 +148,32 @@ public:
      * NB: can be different than width() / height()
      * */
     float aspectRatio() const;
+    /**
+     * Priority of texture upload (higher first, see TextureUploader)
+     * and number of frames which upload was deferred
+     * */
+    inline void setUploadPriority(float p) { uploader_.setPriority(p); }
+    inline uint64_t deferredFrames() const { return uploader_.numDeferred(); }
+    /**
+     * Tell that the last frame updated was rendered (measures latency)
+     * Must be called in rendering update loop
+     * */
+    void rendered();
+    /**
+     * Get latency of the last frames rendered (ms) at the given percentile [0 1]
+     * from their arrival in the stream, or from their capture (live streams)
+     * returns -1 if not measured
+     * */
+    double latency(double percentile, bool capture = false) const;
+    /**
+     * Write the latency of the last frames rendered in CSV, one line per frame
+     * */
+    void writeLatency(std::ostream &out, const std::string &label) const;
     /**
      * Get the OpenGL texture
      * Must be called in OpenGL context
      * */
-    guint texture() const;
+    virtual guint texture() const;
     /**
      * Accept visitors
      * Used for saving session file
@@ -125,6 +185,7 @@ protected:
     // video player description
     uint64_t id_;
     std::string description_;
+    Format format_;
     guint textureindex_;
 
     // general properties of media
@@ -132,6 +193,7 @@ protected:
     guint height_;
     bool single_frame_;
     bool live_;
+    bool low_latency_;
 
     // GST & Play status
     GstClockTime position_;
@@ -167,24 +229,45 @@ protected:
         FrameStatus status;
         bool full;
         GstClockTime position;
-        std::mutex access;
+        GstClockTime arrival;
+        GstClockTime capture;
 
         Frame() {
             full = false;
             status = INVALID;
             position = GST_CLOCK_TIME_NONE;
+            arrival = GST_CLOCK_TIME_NONE;
+            capture = GST_CLOCK_TIME_NONE;
         }
         void unmap();
     };
     Frame frame_[N_FRAME];
-    guint write_index_;
-    guint last_index_;
-    std::mutex index_lock_;
+    FrameQueue frame_queue_;
+
+    // latency from arrival (and capture) to rendering of frames
+    struct LatencySample {
+        GstClockTime render;
+        double arrival;
+        double capture;
+    };
+    GstClockTime updated_arrival_;
+    GstClockTime updated_capture_;
+    std::deque<LatencySample> latency_;
 
     // for PBO
-    guint pbo_[2];
-    guint pbo_index_, pbo_next_index_;
-    guint pbo_size_;
+    TextureUploader uploader_;
+
+    // for native YUV upload (textureindex_ is Y plane or packed pixels)
+    guint yuv_textures_[2];
+    FrameBuffer *yuv_buffer_;
+    Surface *yuv_surface_;
+    void init_planes(guint index);
+    void fill_planes(guint index);
+    void convert_planes();
+    void release_planes();
+
+    // for parallel decoding of JPEG images
+    JpegDecoder *jpeg_;
 
     // gst pipeline control
     virtual void execute_open();
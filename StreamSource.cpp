@@ -98,6 +98,17 @@ void StreamSource::init()
 
 }
 
+void StreamSource::render()
+{
+    bool rendering = renderbuffer_ != nullptr && !suspended_;
+
+    Source::render();
+
+    // the last frame of the stream is now in the render buffer
+    if ( stream_ && rendering )
+        stream_->rendered();
+}
+
 void StreamSource::setActive (bool on)
 {
     bool was_active = active_;
@@ -152,6 +163,13 @@ void StreamSource::update(float dt)
     Source::update(dt);
 
     // update stream
-    if (stream_)
+    if (stream_) {
+        // upload frames of the most visible sources first (source and clones)
+        float p = priority();
+        for (auto c = clones_.begin(); c != clones_.end(); ++c)
+            p = MAX(p, (*c)->priority());
+        stream_->setUploadPriority(p);
+
         stream_->update();
+    }
 }
@@ -29,6 +29,7 @@ public:
 
     // implementation of source API
     void update (float dt) override;
+    void render () override;
     void setActive (bool on) override;
     bool playing () const override;
     void play (bool) override;
@@ -22,6 +22,7 @@
 #include "Session.h"
 #include "FrameBuffer.h"
 #include "Log.h"
+#include "DecoderThreads.h"
 
 #include "Connection.h"
 #include "NetworkToolkit.h"
@@ -327,6 +328,9 @@ void VideoStreamer::init(GstCaps *caps)
         return;
     }
 
+    // streaming threads run on all cores (if render thread is pinned)
+    DecoderThreads::unpinStreamingThreads(pipeline_);
+
     // setup streaming sink
     if (config_.protocol == NetworkToolkit::UDP_JPEG || config_.protocol == NetworkToolkit::UDP_H264) {
         g_object_set (G_OBJECT (gst_bin_get_by_name (GST_BIN (pipeline_), "sink")),
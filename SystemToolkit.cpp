@@ -262,6 +262,17 @@ bool SystemToolkit::file_exists(const string& path)
     // TODO : WIN32 implementation (see tinyfd)
 }
 
+bool SystemToolkit::file_status(const string& path, unsigned long long &size, long long &mtime)
+{
+    struct stat st;
+    if (path.empty() || stat(path.c_str(), &st) != 0)
+        return false;
+
+    size = st.st_size;
+    mtime = st.st_mtime;
+    return true;
+}
+
 
 // tests if dir is a directory and return its path, empty string otherwise
 std::string SystemToolkit::path_directory(const std::string& path)
@@ -54,6 +54,10 @@ namespace SystemToolkit
     // true of file exists
     bool file_exists(const std::string& path);
 
+    // get size (in bytes) and time of last modification (seconds since epoch) of a file
+    // return false if the file cannot be accessed
+    bool file_status(const std::string& path, unsigned long long &size, long long &mtime);
+
     // create directory and return true on success
     bool create_directory(const std::string& path);
 
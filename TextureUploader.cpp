@@ -0,0 +1,289 @@
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+//  Desktop OpenGL function loader
+#include <glad/glad.h>
+
+#include "defines.h"
+#include "Log.h"
+#include "Settings.h"
+#include "PixelBufferRing.h"
+#include "TextureUploader.h"
+
+std::list<TextureUploader*> TextureUploader::uploaders_;
+guint64 TextureUploader::bytes_ = 0;
+guint64 TextureUploader::frame_bytes_ = 0;
+guint64 TextureUploader::flushed_ = 0;
+double TextureUploader::time_ = 0.0;
+double TextureUploader::frame_time_ = 0.0;
+guint64 TextureUploader::total_deferred_ = 0;
+
+// bytes per pixel of the formats of planes
+static guint texel_size(guint format)
+{
+    return format == GL_RED ? 1 : ( format == GL_RG ? 2 : 4 );
+}
+
+TextureUploader::TextureUploader() : nplanes_(0), frame_size_(0), ring_(nullptr), slot_(-1), listed_(false),
+    size_(0), index_(0), pending_(false), priority_(1.f), waiting_(0), deferred_(0)
+{
+    for (guint i = 0; i < TEXTUREUPLOADER_BUFFERS; ++i) {
+        pbo_[i] = 0;
+        fence_[i] = 0;
+    }
+}
+
+TextureUploader::~TextureUploader()
+{
+    reset();
+}
+
+bool TextureUploader::init(guint size)
+{
+    reset();
+
+    glGenBuffers(TEXTUREUPLOADER_BUFFERS, pbo_);
+    for (guint i = 0; i < TEXTUREUPLOADER_BUFFERS; ++i) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_[i]);
+        // glBufferData with NULL pointer reserves only memory space.
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, 0, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    size_ = size;
+    index_ = 0;
+
+    return glGetError() == GL_NO_ERROR;
+}
+
+void TextureUploader::enlist()
+{
+    // flushed only once it has frames to upload
+    if (!listed_) {
+        uploaders_.push_back(this);
+        listed_ = true;
+    }
+}
+
+void TextureUploader::release()
+{
+    // give back the slot of a frame not uploaded
+    if (ring_ && slot_ > -1)
+        ring_->release(slot_);
+    ring_ = nullptr;
+    slot_ = -1;
+}
+
+void TextureUploader::reset()
+{
+    release();
+    if (listed_) {
+        uploaders_.remove(this);
+        listed_ = false;
+    }
+    if (size_ > 0)
+        glDeleteBuffers(TEXTUREUPLOADER_BUFFERS, pbo_);
+    for (guint i = 0; i < TEXTUREUPLOADER_BUFFERS; ++i) {
+        if (fence_[i])
+            glDeleteSync(fence_[i]);
+        pbo_[i] = 0;
+        fence_[i] = 0;
+    }
+    size_ = 0;
+    nplanes_ = 0;
+    frame_size_ = 0;
+    pending_ = false;
+    waiting_ = 0;
+}
+
+void TextureUploader::set(const Plane *planes, guint n, guint size)
+{
+    nplanes_ = MIN(n, TEXTUREUPLOADER_PLANES);
+    for (guint p = 0; p < nplanes_; ++p)
+        planes_[p] = planes[p];
+    frame_size_ = size;
+    pending_ = true;
+}
+
+void TextureUploader::submit(guint texture, const guint8 *pixels, guint w, guint h)
+{
+    Plane rgba = { texture, w, h, GL_RGBA, w * 4, pixels, 0 };
+    submit(&rgba, 1);
+}
+
+void TextureUploader::submit(const Plane *planes, guint n)
+{
+    guint64 t = g_get_monotonic_time();
+    guint size = 0;
+    for (guint p = 0; p < n; ++p)
+        size += planes[p].stride * planes[p].height;
+
+    // a frame of a ring not flushed yet is replaced
+    bool replace = pending_ && ring_ == nullptr;
+    release();
+
+    // (re)create buffers for frames of this size
+    if ( size != size_ && !init(size) ) {
+        reset();
+        Log::Warning("Failed to create pixel buffers; uploading textures without PBO.");
+    }
+
+    // without PBO, use standard opengl (slower)
+    if ( size_ < 1 ) {
+        for (guint p = 0; p < n; ++p) {
+            glBindTexture(GL_TEXTURE_2D, planes[p].texture);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, planes[p].stride / texel_size(planes[p].format));
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, planes[p].width, planes[p].height,
+                            planes[p].format, GL_UNSIGNED_BYTE, planes[p].data);
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        pending_ = false;
+        bytes_ += size;
+        time_ += (double) (g_get_monotonic_time() - t) / 1000.0;
+        if (callback_)
+            callback_();
+        return;
+    }
+    enlist();
+
+    // take the next buffer (a pending frame not flushed yet is replaced)
+    if (!replace)
+        index_ = (index_ + 1) % TEXTUREUPLOADER_BUFFERS;
+
+    // no need for the driver to synchronize if the previous transfer of this buffer is over
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+    if (fence_[index_]) {
+        if ( glClientWaitSync(fence_[index_], 0, 0) != GL_TIMEOUT_EXPIRED )
+            flags |= GL_MAP_UNSYNCHRONIZED_BIT;
+        glDeleteSync(fence_[index_]);
+        fence_[index_] = 0;
+    }
+    else if (!replace)
+        flags |= GL_MAP_UNSYNCHRONIZED_BIT;
+
+    // copy pixels of planes one after the other in the mapped buffer
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_[index_]);
+    guint8 *ptr = (guint8 *) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size_, flags);
+    if (ptr) {
+        Plane copy[TEXTUREUPLOADER_PLANES];
+        guint offset = 0;
+        for (guint p = 0; p < n && p < TEXTUREUPLOADER_PLANES; ++p) {
+            copy[p] = planes[p];
+            copy[p].offset = offset;
+            memcpy(ptr + offset, planes[p].data, planes[p].stride * planes[p].height);
+            offset += planes[p].stride * planes[p].height;
+        }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        set(copy, n, size);
+    }
+    else
+        pending_ = false;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    time_ += (double) (g_get_monotonic_time() - t) / 1000.0;
+}
+
+void TextureUploader::submit(PixelBufferRing *ring, int slot, const Plane *planes, guint n)
+{
+    guint size = 0;
+    for (guint p = 0; p < n; ++p)
+        size += planes[p].stride * planes[p].height;
+
+    // a frame not flushed yet is replaced
+    release();
+    enlist();
+
+    ring_ = ring;
+    slot_ = slot;
+    set(planes, n, size);
+}
+
+void TextureUploader::upload()
+{
+    if (!pending_)
+        return;
+
+    guint64 t = g_get_monotonic_time();
+
+    // copy pixels of each plane from PBO (or from slot of ring) to its texture object
+    if (ring_ == nullptr)
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_[index_]);
+    for (guint p = 0; p < nplanes_; ++p) {
+        const Plane &pl = planes_[p];
+        glBindTexture(GL_TEXTURE_2D, pl.texture);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, pl.stride / texel_size(pl.format));
+        if (ring_)
+            ring_->upload(slot_, pl.width, pl.height, pl.format, GL_UNSIGNED_BYTE, pl.offset);
+        else
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pl.width, pl.height, pl.format, GL_UNSIGNED_BYTE,
+                            (void *) static_cast<size_t>(pl.offset));
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // buffer is in use until transfer is done
+    // (slot of a ring is given back to the ring which fences it)
+    if (ring_) {
+        ring_->lock(slot_);
+        ring_ = nullptr;
+        slot_ = -1;
+    }
+    else
+        fence_[index_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pending_ = false;
+    waiting_ = 0;
+
+    bytes_ += frame_size_;
+    time_ += (double) (g_get_monotonic_time() - t) / 1000.0;
+
+    // e.g. convert planes
+    if (callback_)
+        callback_();
+}
+
+guint64 TextureUploader::budget()
+{
+    return static_cast<guint64>( MAX(Settings::application.render.upload_budget, 0) ) * 1048576;
+}
+
+void TextureUploader::flush()
+{
+    // frames to upload, by order of priority (increased while waiting)
+    std::vector<TextureUploader *> pending;
+    for (auto u = uploaders_.begin(); u != uploaders_.end(); ++u) {
+        if ( (*u)->pending_ )
+            pending.push_back(*u);
+    }
+    std::stable_sort(pending.begin(), pending.end(), [](const TextureUploader *a, const TextureUploader *b) {
+        return a->priority_ + a->waiting_ * TEXTUREUPLOADER_WAIT_PRIORITY >
+               b->priority_ + b->waiting_ * TEXTUREUPLOADER_WAIT_PRIORITY; });
+
+    // upload in the limit of the budget left in this frame (at least one
+    // per frame), defer the others
+    guint64 limit = budget();
+    guint64 bytes = flushed_;
+    for (auto u = pending.begin(); u != pending.end(); ++u) {
+        if ( limit > 0 && bytes > 0 && bytes + (*u)->frame_size_ > limit ) {
+            ++(*u)->waiting_;
+            ++(*u)->deferred_;
+            ++total_deferred_;
+            continue;
+        }
+        bytes += (*u)->frame_size_;
+        (*u)->upload();
+    }
+    flushed_ = bytes;
+}
+
+void TextureUploader::nextFrame()
+{
+    // statistics of the frame (submit and upload)
+    flushed_ = 0;
+    frame_bytes_ = bytes_;
+    frame_time_ = time_;
+    bytes_ = 0;
+    time_ = 0.0;
+}
@@ -0,0 +1,183 @@
+#ifndef TEXTUREUPLOADER_H
+#define TEXTUREUPLOADER_H
+
+#include <list>
+#include <functional>
+
+#include <glib.h>
+
+#define TEXTUREUPLOADER_BUFFERS 3
+#define TEXTUREUPLOADER_PLANES 3
+// priority gained by a frame for each flush it is deferred
+#define TEXTUREUPLOADER_WAIT_PRIORITY 0.5f
+
+typedef struct __GLsync *GLsync;
+class PixelBufferRing;
+
+/**
+ * @brief The TextureUploader class
+ *
+ * Uploads the frames of a stream into its texture through Pixel
+ * Buffer Objects, for all the streams and media players. A frame is
+ * either RGBA, or made of planes each uploaded in its own texture
+ * (e.g. YUV), and is either copied in the PBO of the uploader, or
+ * already written in a slot of a persistent ring (PixelBufferRing).
+ *
+ * Submitting a frame only copies its pixels into a free PBO; the
+ * transfers of all the frames submitted are then issued together once
+ * all sources of a session are updated and before they render (flush),
+ * so that rendering sources one after another does not interleave with
+ * uploads. A fence guards
+ * each PBO until its transfer is done, and a PBO still in use is
+ * never waited for (the driver gives new memory instead). The slot of
+ * a ring is given back to the ring once uploaded (or if the frame is
+ * replaced), and the ring fences it.
+ *
+ * The bytes uploaded at each frame are limited by a budget (Settings),
+ * shared by the flushes of the frame (sessions inside sessions):
+ * frames are uploaded in order of priority of their texture, and the
+ * others are deferred to the next flush (replaced by a newer frame if
+ * one is submitted meanwhile). A deferred frame gains priority so that
+ * it is not deferred forever.
+ *
+ * Bytes and time spent uploading are measured for each frame.
+ */
+class TextureUploader
+{
+public:
+    /**
+     * Plane of a frame: texture (created with glTexStorage2D at the size
+     * of the plane), format (GL_RGBA, GL_RG or GL_RED of unsigned bytes),
+     * bytes per row, and either its pixels (to copy) or its offset in the
+     * slot of a ring
+     * */
+    struct Plane {
+        guint texture;
+        guint width;
+        guint height;
+        guint format;
+        guint stride;
+        const guint8 *data;
+        guint offset;
+    };
+
+    TextureUploader();
+    /**
+     * Destructor.
+     * Must be called in OpenGL context
+     * */
+    ~TextureUploader();
+    // non assignable class
+    TextureUploader(TextureUploader const&) = delete;
+    TextureUploader& operator=(TextureUploader const&) = delete;
+    /**
+     * Submit the pixels of an RGBA frame of w x h to upload into
+     * the texture (created with glTexStorage2D at this size) at next flush
+     * Must be called in OpenGL context
+     * */
+    void submit(guint texture, const guint8 *pixels, guint w, guint h);
+    /**
+     * Submit the pixels of the n planes of a frame (data of planes)
+     * to upload at next flush
+     * Must be called in OpenGL context
+     * */
+    void submit(const Plane *planes, guint n);
+    /**
+     * Submit a frame already written in the slot of a ring (offset of
+     * planes) to upload at next flush; the slot belongs to the uploader
+     * until then
+     * Must be called in OpenGL context
+     * */
+    void submit(PixelBufferRing *ring, int slot, const Plane *planes, guint n);
+    /**
+     * Function called after each upload (e.g. conversion of planes)
+     * Must be called in OpenGL context
+     * */
+    inline void setCallback(std::function<void()> f) { callback_ = f; }
+    /**
+     * Upload the frame submitted now (e.g. to display a seek at once)
+     * Must be called in OpenGL context
+     * */
+    void upload();
+    /**
+     * Free buffers and cancel upload (e.g. before deleting texture)
+     * Must be called in OpenGL context
+     * */
+    void reset();
+    /**
+     * Priority of the texture for uploads at flush (higher first)
+     * */
+    inline void setPriority(float p) { priority_ = p; }
+    inline float priority() const { return priority_; }
+    /**
+     * Number of frames deferred to a later flush
+     * */
+    inline guint64 numDeferred() const { return deferred_; }
+    /**
+     * True if the frame submitted is not uploaded yet
+     * */
+    inline bool pending() const { return pending_; }
+
+    // shared engine
+    /**
+     * Upload the frames submitted, to be called after update of sources
+     * and before they render (in the limit of the budget of the frame,
+     * the others are deferred)
+     * Must be called in OpenGL context
+     * */
+    static void flush();
+    /**
+     * Start a new frame (statistics of the previous frame, and budget)
+     * */
+    static void nextFrame();
+    /**
+     * Maximum bytes uploaded at each frame (0 for no limit)
+     * */
+    static guint64 budget();
+    /**
+     * Number of frames deferred by all uploaders
+     * */
+    static guint64 totalDeferred() { return total_deferred_; }
+    /**
+     * Bytes uploaded during the last frame
+     * */
+    static guint64 frameBytes() { return frame_bytes_; }
+    /**
+     * Time spent uploading during the last frame (ms)
+     * */
+    static double frameTime() { return frame_time_; }
+    /**
+     * Number of textures with an uploader
+     * */
+    static size_t numUploaders() { return uploaders_.size(); }
+
+private:
+    bool init(guint size);
+    void enlist();
+    void set(const Plane *planes, guint n, guint size);
+    void release();
+
+    Plane planes_[TEXTUREUPLOADER_PLANES];
+    guint nplanes_;
+    guint frame_size_;
+    PixelBufferRing *ring_;
+    int slot_;
+    std::function<void()> callback_;
+    bool listed_;
+    guint size_;
+    guint pbo_[TEXTUREUPLOADER_BUFFERS];
+    GLsync fence_[TEXTUREUPLOADER_BUFFERS];
+    guint index_;
+    bool pending_;
+    float priority_;
+    guint waiting_;
+    guint64 deferred_;
+
+    // global list of uploaders and statistics
+    static std::list<TextureUploader*> uploaders_;
+    static guint64 bytes_, frame_bytes_, flushed_;
+    static double time_, frame_time_;
+    static guint64 total_deferred_;
+};
+
+#endif // TEXTUREUPLOADER_H
@@ -4,6 +4,7 @@
 
 #include "defines.h"
 #include "Log.h"
+#include "GstToolkit.h"
 #include "Timeline.h"
 
 
@@ -42,6 +43,8 @@ Timeline& Timeline::operator = (const Timeline& b)
         if (b.first_ != GST_CLOCK_TIME_NONE)
             this->first_ = b.first_;
         this->gaps_ = b.gaps_;
+        if (!b.keyframes_.empty())
+            this->keyframes_ = b.keyframes_;
         this->gaps_array_need_update_ = b.gaps_array_need_update_;
         memcpy( this->gapsArray_, b.gapsArray_, MAX_TIMELINE_ARRAY * sizeof(float));
         memcpy( this->fadingArray_, b.fadingArray_, MAX_TIMELINE_ARRAY * sizeof(float));
@@ -59,6 +62,7 @@ void Timeline::reset()
 
     clearGaps();
     clearFading();
+    keyframes_.clear();
 }
 
 bool Timeline::is_valid()
@@ -66,6 +70,11 @@ bool Timeline::is_valid()
     return timing_.is_valid() && step_ != GST_CLOCK_TIME_NONE;
 }
 
+bool Timeline::equivalent(const Timeline& b) const
+{
+    return timing_ == b.timing_ && step_ == b.step_ && gaps_ == b.gaps_;
+}
+
 void Timeline::setFirst(GstClockTime first)
 {
     first_ = first;
@@ -159,7 +168,7 @@ bool Timeline::cut(GstClockTime t, bool left, bool join_extremity)
     {
         TimeIntervalSet::iterator gap = std::find_if(gaps_.begin(), gaps_.end(), includesTime(t));
 
-        // cut left part
+        // cut left part (section starts at t)
         if (left) {
             // cut a gap
             if ( gap != gaps_.end() )
@@ -226,6 +235,10 @@ bool Timeline::cut(GstClockTime t, bool left, bool join_extremity)
         }
     }
 
+    // playback will jump to t
+    if (ret && left)
+        checkSeekCost(t);
+
     return ret;
 }
 
@@ -388,6 +401,26 @@ TimeIntervalSet Timeline::sections() const
     return sec;
 }
 
+TimeInterval Timeline::sectionAfter(GstClockTime t, bool forward) const
+{
+    TimeInterval section;
+    TimeIntervalSet sec = sections();
+
+    // section including t, otherwise the next one in the direction given
+    if (forward) {
+        auto it = std::find_if(sec.begin(), sec.end(), [t](const TimeInterval &s){ return s.end > t; });
+        if (it != sec.end())
+            section = *it;
+    }
+    else {
+        auto it = std::find_if(sec.rbegin(), sec.rend(), [t](const TimeInterval &s){ return s.begin < t; });
+        if (it != sec.rend())
+            section = *it;
+    }
+
+    return section;
+}
+
 void Timeline::clearGaps()
 {
     gaps_.clear();
@@ -612,9 +645,75 @@ bool Timeline::autoCut()
     updateGapsFromArray(gapsArray_, MAX_TIMELINE_ARRAY);
     gaps_array_need_update_ = false;
 
+    // playback jumps to the begining of sections
+    if (changed) {
+        TimeIntervalSet sec = sections();
+        for (auto it = sec.begin(); it != sec.end(); ++it)
+            checkSeekCost( (*it).begin );
+    }
+
     return changed;
 }
 
+void Timeline::setKeyframes(const std::vector<GstClockTime> &keyframes)
+{
+    keyframes_ = keyframes;
+    std::sort(keyframes_.begin(), keyframes_.end());
+}
+
+GstClockTime Timeline::keyframeBefore(GstClockTime t) const
+{
+    // last keyframe at or before t
+    auto k = std::upper_bound(keyframes_.begin(), keyframes_.end(), t);
+    if (k == keyframes_.begin())
+        return timing_.begin;
+    return *(--k);
+}
+
+GstClockTime Timeline::keyframeNear(GstClockTime t, GstClockTime tolerance) const
+{
+    GstClockTime near = t;
+    GstClockTime distance = tolerance;
+
+    // closest keyframe to t, if not further than tolerance
+    auto k = std::lower_bound(keyframes_.begin(), keyframes_.end(), t);
+    if (k != keyframes_.end() && *k - t <= distance) {
+        near = *k;
+        distance = *k - t;
+    }
+    if (k != keyframes_.begin() && t - *(k-1) < distance)
+        near = *(k-1);
+
+    return near;
+}
+
+GstClockTime Timeline::seekCost(GstClockTime t) const
+{
+    // no index: cannot tell (or every frame is a keyframe)
+    if (keyframes_.empty() || t == GST_CLOCK_TIME_NONE)
+        return 0;
+
+    // frames to decode from previous keyframe
+    return t - MIN(t, keyframeBefore(t));
+}
+
+GstClockTime Timeline::keyframeInterval() const
+{
+    // average distance between keyframes
+    if (keyframes_.size() < 2)
+        return GST_CLOCK_TIME_NONE;
+
+    return (keyframes_.back() - keyframes_.front()) / (keyframes_.size() - 1);
+}
+
+void Timeline::checkSeekCost(GstClockTime t) const
+{
+    GstClockTime cost = seekCost(t);
+    if ( t > timing_.begin && cost > TIMELINE_SEEK_COST_WARNING )
+        Log::Warning("Cut at %s is %s after a keyframe; playback might hesitate when jumping there.",
+                     GstToolkit::time_to_string(t).c_str(), GstToolkit::time_to_string(cost).c_str());
+}
+
 void Timeline::updateGapsFromArray(float *array, size_t array_size)
 {
     // reset gaps
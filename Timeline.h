@@ -5,10 +5,13 @@
 #include <sstream>
 #include <set>
 #include <list>
+#include <vector>
 
 #include <gst/pbutils/pbutils.h>
 
 #define MAX_TIMELINE_ARRAY 2000
+// distance to previous keyframe making a cut point slow to seek
+#define TIMELINE_SEEK_COST_WARNING (GST_SECOND)
 
 struct TimeInterval
 {
@@ -88,6 +91,8 @@ public:
     Timeline& operator = (const Timeline& b);
 
     bool is_valid();
+    // same timing and gaps (i.e. same playback, regardless of fading)
+    bool equivalent(const Timeline& b) const;
     void update();
     void refresh();
 
@@ -124,10 +129,19 @@ public:
 
     // inverse of gaps: sections of play areas
     TimeIntervalSet sections() const;
+    TimeInterval sectionAfter(GstClockTime t, bool forward = true) const;
     GstClockTime sectionsDuration() const;
     GstClockTime sectionsTimeAt(GstClockTime t) const;
     size_t fillSectionsArrays(float * const gaps, float * const fading);
 
+    // Keyframes of media: cost of seeking (empty if unknown or all frames are keyframes)
+    void setKeyframes(const std::vector<GstClockTime> &keyframes);
+    inline bool hasKeyframes() const { return !keyframes_.empty(); }
+    GstClockTime keyframeBefore(GstClockTime t) const;
+    GstClockTime keyframeNear(GstClockTime t, GstClockTime tolerance) const;
+    GstClockTime seekCost(GstClockTime t) const;
+    GstClockTime keyframeInterval() const;
+
     // Manipulation of Fading
     float fadingAt(const GstClockTime t) const;
     size_t fadingIndexAt(const GstClockTime t) const;
@@ -165,6 +179,9 @@ private:
 
     float fadingArray_[MAX_TIMELINE_ARRAY];
 
+    // sorted times of keyframes
+    std::vector<GstClockTime> keyframes_;
+    void checkSeekCost(GstClockTime t) const;
 };
 
 #endif // TIMELINE_H
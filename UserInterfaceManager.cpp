@@ -55,6 +55,9 @@ using namespace std;
 #include "Selection.h"
 #include "FrameBuffer.h"
 #include "MediaPlayer.h"
+#include "FrameCache.h"
+#include "FrameQueue.h"
+#include "TextureUploader.h"
 #include "MediaSource.h"
 #include "SessionSource.h"
 #include "PatternSource.h"
@@ -1667,6 +1670,66 @@ void UserInterface::RenderMetrics(bool *p_open, int* p_corner, int *p_mode)
         //        ImGui::Text("HiDPI (retina) %s", io.DisplayFramebufferScale.x > 1.f ? "on" : "off");
         ImGui::Text("Refresh %.1f FPS", io.Framerate);
         ImGui::Text("Memory  %s", BaseToolkit::byte_to_string( SystemToolkit::memory_usage()).c_str() );
+        if ( FrameCache::numCaches() > 0 ) {
+            guint64 n = FrameCache::numHits() + FrameCache::numMisses();
+            ImGui::Text("Cache   %s, %.0f%% hit", BaseToolkit::byte_to_string( FrameCache::memoryUsage()).c_str(),
+                        n > 0 ? 100.0 * (double) FrameCache::numHits() / (double) n : 0.0 );
+        }
+        if ( TextureUploader::numUploaders() > 0 )
+            ImGui::Text("Upload  %s, %.1f ms", BaseToolkit::byte_to_string( TextureUploader::frameBytes()).c_str(),
+                        TextureUploader::frameTime() );
+        if ( TextureUploader::totalDeferred() > 0 ) {
+            for (auto s = Mixer::manager().session()->begin(); s != Mixer::manager().session()->end(); ++s) {
+                uint64_t deferred = 0;
+                MediaSource *ms = dynamic_cast<MediaSource *>(*s);
+                if (ms != nullptr)
+                    deferred = ms->mediaplayer()->deferredFrames();
+                StreamSource *ss = dynamic_cast<StreamSource *>(*s);
+                if (ss != nullptr && ss->stream() != nullptr)
+                    deferred = ss->stream()->deferredFrames();
+                if (deferred > 0)
+                    ImGui::Text("Defer   %lu frames %s", (unsigned long) deferred, (*s)->name().c_str());
+            }
+        }
+        if ( FrameQueue::totalDropped() > 0 )
+            ImGui::Text("Dropped %lu frames", (unsigned long) FrameQueue::totalDropped());
+        // latency from arrival (and capture) to rendering of frames of live streams
+        bool live = false;
+        for (auto s = Mixer::manager().session()->begin(); s != Mixer::manager().session()->end(); ++s) {
+            StreamSource *ss = dynamic_cast<StreamSource *>(*s);
+            if (ss == nullptr || ss->stream() == nullptr || !ss->stream()->live() || ss->stream()->latency(0.5) < 0.0)
+                continue;
+            live = true;
+            Stream *st = ss->stream();
+            ImGui::Text("Latency %.1f/%.1f/%.1f ms %s", st->latency(0.5), st->latency(0.95), st->latency(0.99),
+                        (*s)->name().c_str());
+            if ( st->latency(0.5, true) > -1.0 )
+                ImGui::Text("Capture %.1f/%.1f/%.1f ms %s", st->latency(0.5, true), st->latency(0.95, true),
+                            st->latency(0.99, true), (*s)->name().c_str());
+        }
+        if ( live && ImGui::SmallButton("Save latency (CSV)") ) {
+            std::string filename = SystemToolkit::full_filename( SystemToolkit::home_path(), SystemToolkit::date_time_string() + "_vmixlatency.csv" );
+            std::ofstream csv(filename);
+            if (csv.is_open()) {
+                csv << "source,render_us,arrival_ms,capture_ms\n";
+                for (auto s = Mixer::manager().session()->begin(); s != Mixer::manager().session()->end(); ++s) {
+                    StreamSource *ss = dynamic_cast<StreamSource *>(*s);
+                    if (ss != nullptr && ss->stream() != nullptr)
+                        ss->stream()->writeLatency(csv, (*s)->name());
+                }
+                Log::Notify("Latency saved in %s", filename.c_str());
+            }
+            else
+                Log::Warning("Failed to write %s", filename.c_str());
+        }
+        for (auto mp = MediaPlayer::begin(); mp != MediaPlayer::end(); ++mp) {
+            if ( (*mp)->syncGroup() != GST_CLOCK_TIME_NONE )
+                ImGui::Text("Sync    %+.1f ms %s", (double) (*mp)->syncOffset() / (double) GST_MSECOND,
+                            SystemToolkit::base_filename( (*mp)->filename() ).c_str() );
+            if ( (*mp)->isPlaying() && ABS((*mp)->playSpeed()) > 1.0 )
+                ImGui::Text("Speed   x%.1f %.0f/%.0f fps %s", (*mp)->playSpeed(), (*mp)->updateFrameRate(),
+                            (*mp)->displayFrameRate(), SystemToolkit::base_filename( (*mp)->filename() ).c_str() );
+        }
         ImGui::PopFont();
 
     }
@@ -2062,6 +2125,21 @@ void SourceController::Render()
                 Mixer::selection().clear();
             }
 
+            // all media files of the session decoded from RAM
+            std::list<MediaPlayer *> players;
+            for (auto source = Mixer::manager().session()->begin(); source != Mixer::manager().session()->end(); ++source) {
+                MediaSource *ms = dynamic_cast<MediaSource *>(*source);
+                if (ms != nullptr && ms->mediaplayer()->isMemoryLoadable())
+                    players.push_back(ms->mediaplayer());
+            }
+            bool memory = !players.empty();
+            for (auto mp = players.begin(); mp != players.end(); ++mp)
+                memory &= (*mp)->memoryEnabled();
+            if ( ImGui::MenuItem( ICON_FA_HDD "  Load all files in RAM", nullptr, &memory, !players.empty()) ) {
+                for (auto mp = players.begin(); mp != players.end(); ++mp)
+                    (*mp)->setMemoryEnabled(memory);
+            }
+
             ImGui::Separator();
             bool pinned = Settings::application.widget.media_player_view == Settings::application.current_view;
             if ( ImGui::MenuItem( ICON_FA_MAP_PIN "    Pin window to view", nullptr, &pinned) ){
@@ -2096,6 +2174,8 @@ void SourceController::Render()
                 Mixer::manager().session()->addPlayGroup( ids(playable_only(selection_)) );
                 info_.reset();
             }
+            // Menu : play stored selections frame synchronous
+            ImGui::MenuItem(ICON_FA_LINK "  Synchronized play", NULL, &Settings::application.widget.media_player_sync);
             // Menu : list of selections
             if (N>0) {
                 ImGui::Separator();
@@ -2130,6 +2210,14 @@ void SourceController::Render()
                 if ( ImGui::MenuItem(LABEL_EDIT_FADING) )
                     mediaplayer_edit_fading_ = true;
 
+                bool cache = mediaplayer_active_->cacheEnabled();
+                if ( ImGui::MenuItem(ICON_FA_MEMORY "  Cache frames in RAM", NULL, &cache, mediaplayer_active_->isCacheable()) )
+                    mediaplayer_active_->setCacheEnabled(cache);
+
+                bool memory = mediaplayer_active_->memoryEnabled();
+                if ( ImGui::MenuItem(ICON_FA_HDD "  Load file in RAM", NULL, &memory, mediaplayer_active_->isMemoryLoadable()) )
+                    mediaplayer_active_->setMemoryEnabled(memory);
+
 //                if (ImGui::BeginMenu(ICON_FA_CUT "  Auto cut" ))
 //                {
 //                    if (ImGuiToolkit::MenuItemIcon(14, 12,  "Cut faded areas" ))
@@ -2902,6 +2990,16 @@ void SourceController::RenderMediaPlayer(MediaPlayer *mp)
         }
     }
 
+    // File in RAM: progress of loading, then icon
+    if ( mediaplayer_active_->memoryEnabled() ) {
+        ImGui::SetCursorScreenPos(top_image + ImVec2(h_space_, v_space_));
+        float progress = mediaplayer_active_->memoryProgress();
+        if ( mediaplayer_active_->isMemoryResident() )
+            ImGui::Text(ICON_FA_HDD);
+        else if ( progress > -1.f )
+            ImGui::Text(ICON_FA_HDD " %.0f%%", progress * 100.f);
+    }
+
     // Play icon lower left corner
     ImGuiToolkit::PushFont(ImGuiToolkit::FONT_LARGE);
     ImGui::SetCursorScreenPos(bottom + ImVec2(h_space_, -ImGui::GetTextLineHeightWithSpacing()));
@@ -3102,7 +3200,8 @@ void SourceController::RenderMediaPlayer(MediaPlayer *mp)
     ///
 
     // request seek (ASYNC)
-    if ( mediaplayer_slider_pressed_ && mediaplayer_active_->go_to(seek_t) )
+    // (with SHIFT, snap to keyframes for faster seek)
+    if ( mediaplayer_slider_pressed_ && mediaplayer_active_->go_to(seek_t, UserInterface::manager().shiftModifier()) )
         mediaplayer_slider_pressed_ = false;
 
     // play/stop command should be following the playing mode (buttons)
@@ -3244,18 +3343,14 @@ void SourceController::DrawButtonBar(ImVec2 bottom, float width)
             }
         }
         else {
-            if (ImGui::Button(ICON_FA_PLAY) && enabled){
-                for (auto source = selection_.begin(); source != selection_.end(); ++source)
-                    (*source)->play(true);
-            }
+            if (ImGui::Button(ICON_FA_PLAY) && enabled)
+                PlaySelection();
         }
     }
     // separate play & pause buttons for disagreeing sources
     else {
-        if (ImGui::Button(ICON_FA_PLAY) && enabled) {
-            for (auto source = selection_.begin(); source != selection_.end(); ++source)
-                (*source)->play(true);
-        }
+        if (ImGui::Button(ICON_FA_PLAY) && enabled)
+            PlaySelection();
         ImGui::SameLine(0, h_space_);
         if (ImGui::Button(ICON_FA_PAUSE) && enabled) {
             for (auto source = selection_.begin(); source != selection_.end(); ++source)
@@ -3268,6 +3363,26 @@ void SourceController::DrawButtonBar(ImVec2 bottom, float width)
     ImGui::PopStyleColor(3);
 }
 
+void SourceController::PlaySelection()
+{
+    // stored selection in synchronized mode: media players start together
+    if ( active_selection_ > -1 && Settings::application.widget.media_player_sync ) {
+        std::list<MediaPlayer *> players;
+        for (auto source = selection_.begin(); source != selection_.end(); ++source) {
+            MediaSource *ms = dynamic_cast<MediaSource *>(*source);
+            if (ms)
+                players.push_back( ms->mediaplayer() );
+            else
+                (*source)->play(true);
+        }
+        MediaPlayer::playSynchronized(players);
+    }
+    else {
+        for (auto source = selection_.begin(); source != selection_.end(); ++source)
+            (*source)->play(true);
+    }
+}
+
 ///
 /// NAVIGATOR
 ///
@@ -4454,6 +4569,9 @@ void Navigator::RenderMainPannelSettings()
         ImGui::Text("Options");
         ImGuiToolkit::ButtonSwitch( ICON_FA_MOUSE_POINTER "  Smooth cursor", &Settings::application.smooth_cursor);
         ImGuiToolkit::ButtonSwitch( ICON_FA_TACHOMETER_ALT " Metrics", &Settings::application.widget.stats);
+        ImGui::SetNextItemWidth(IMGUI_RIGHT_ALIGN);
+        ImGui::SliderInt("Unload limbo", &Settings::application.source.inactive_release, 0, 300,
+                         Settings::application.source.inactive_release < 1 ? "Never" : "After %d s");
 
 #ifndef NDEBUG
         ImGui::Text("Expert");
@@ -4477,17 +4595,35 @@ void Navigator::RenderMainPannelSettings()
         static bool blit = Settings::application.render.blit;
         static bool multi = (Settings::application.render.multisampling > 0);
         static bool gpu = Settings::application.render.gpu_decoding;
+        static bool yuv = Settings::application.render.native_yuv;
+        static bool affinity = Settings::application.render.render_affinity;
         bool change = false;
         change |= ImGuiToolkit::ButtonSwitch( "Vertical synchronization", &vsync);
         change |= ImGuiToolkit::ButtonSwitch( "Blit framebuffer", &blit);
         change |= ImGuiToolkit::ButtonSwitch( "Antialiasing framebuffer", &multi);
         change |= ImGuiToolkit::ButtonSwitch( ICON_FA_MICROCHIP " Hardware video decoding", &gpu);
+        change |= ImGuiToolkit::ButtonSwitch( "GPU colorspace conversion", &yuv);
+        change |= ImGuiToolkit::ButtonSwitch( "Render thread on one core", &affinity);
+        // applies without restart
+        ImGuiToolkit::ButtonSwitch( "Decode video at display size", &Settings::application.render.adaptive_decoding);
+        // applies to videos opened after change
+        ImGui::SetNextItemWidth(IMGUI_RIGHT_ALIGN);
+        ImGui::SliderInt("Decoder threads", &Settings::application.render.decoder_threads, 0,
+                         2 * (int) std::thread::hardware_concurrency(),
+                         Settings::application.render.decoder_threads < 1 ? "Auto" : "%d");
+        // applies to devices opened after change
+        ImGuiToolkit::ButtonSwitch( "Low latency capture", &Settings::application.render.low_latency_capture);
+        ImGui::SetNextItemWidth(IMGUI_RIGHT_ALIGN);
+        ImGui::SliderInt("Upload budget", &Settings::application.render.upload_budget, 0, 512,
+                         Settings::application.render.upload_budget < 1 ? "Unlimited" : "%d MB/frame");
 
         if (change) {
             need_restart = ( vsync != (Settings::application.render.vsync > 0) ||
                  blit != Settings::application.render.blit ||
                  multi != (Settings::application.render.multisampling > 0) ||
-                 gpu != Settings::application.render.gpu_decoding );
+                 gpu != Settings::application.render.gpu_decoding ||
+                 yuv != Settings::application.render.native_yuv ||
+                 affinity != Settings::application.render.render_affinity );
         }
         if (need_restart) {
             ImGui::Spacing();
@@ -4496,6 +4632,8 @@ void Navigator::RenderMainPannelSettings()
                 Settings::application.render.blit = blit;
                 Settings::application.render.multisampling = multi ? 3 : 0;
                 Settings::application.render.gpu_decoding = gpu;
+                Settings::application.render.native_yuv = yuv;
+                Settings::application.render.render_affinity = affinity;
                 Rendering::manager().close();
             }
         }
@@ -122,6 +122,7 @@ class SourceController
 
     // re-usable ui parts
     void DrawButtonBar(ImVec2 bottom, float width);
+    void PlaySelection();
     const char *SourcePlayIcon(Source *s);
     bool SourceButton(Source *s, ImVec2 framesize);
 
@@ -0,0 +1,78 @@
+#include "WorkerPool.h"
+
+std::atomic<WorkerPool::ThreadInit> WorkerPool::thread_init_(nullptr);
+
+WorkerPool::WorkerPool(size_t n) : stop_(false)
+{
+    if (n < 1)
+        n = std::max( std::thread::hardware_concurrency(), 1u );
+
+    for (size_t i = 0; i < n; ++i)
+        workers_.emplace_back( &WorkerPool::work, this );
+}
+
+WorkerPool::~WorkerPool()
+{
+    access_.lock();
+    stop_ = true;
+    jobs_.clear();
+    access_.unlock();
+
+    condition_.notify_all();
+    for (auto w = workers_.begin(); w != workers_.end(); ++w)
+        w->join();
+}
+
+void WorkerPool::push(std::function<void()> run, Priority priority)
+{
+    access_.lock();
+    jobs_.push_back( {run, priority} );
+    access_.unlock();
+
+    condition_.notify_one();
+}
+
+void WorkerPool::cancel(Priority priority)
+{
+    if (priority == nullptr)
+        return;
+
+    // NB: destroying the job breaks the promise of its future
+    std::lock_guard<std::mutex> lock(access_);
+    jobs_.remove_if( [priority](const Job &j){ return j.priority == priority; } );
+}
+
+size_t WorkerPool::numPending()
+{
+    std::lock_guard<std::mutex> lock(access_);
+    return jobs_.size();
+}
+
+void WorkerPool::work()
+{
+    ThreadInit init = thread_init_;
+    if (init)
+        init();
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(access_);
+            condition_.wait(lock, [this]{ return stop_ || !jobs_.empty(); });
+            if (stop_)
+                return;
+
+            // pick the first job of highest priority (lowest value)
+            auto next = jobs_.begin();
+            for (auto j = jobs_.begin(); j != jobs_.end(); ++j) {
+                int pj = j->priority ? j->priority->load() : 0;
+                int pn = next->priority ? next->priority->load() : 0;
+                if (pj < pn)
+                    next = j;
+            }
+            job = *next;
+            jobs_.erase(next);
+        }
+        job.run();
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <memory>
+#include <future>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <list>
+
+/**
+ * @brief The WorkerPool class
+ *
+ * Fixed number of threads executing jobs from a priority queue.
+ *
+ * The priority of a job is read when a worker becomes free (lower
+ * value runs first, in order of submission for equal priority), so
+ * that the owner of a job can change its priority until it starts.
+ * Jobs not started yet can be cancelled; their future then becomes
+ * ready with a broken promise.
+ */
+class WorkerPool
+{
+public:
+    typedef std::shared_ptr< std::atomic<int> > Priority;
+    static Priority priority(int p = 0) { return std::make_shared< std::atomic<int> >(p); }
+
+    /**
+     * Function called by each worker thread when it starts
+     * (e.g. to set the affinity of the thread)
+     * */
+    typedef void (*ThreadInit)();
+    static void setThreadInit(ThreadInit init) { thread_init_ = init; }
+
+    /**
+     * Create a pool of n workers (default to number of cores)
+     * */
+    WorkerPool(size_t n = 0);
+    /**
+     * Destructor: waits for running jobs, drops pending jobs
+     * */
+    ~WorkerPool();
+    // non assignable class
+    WorkerPool(WorkerPool const&) = delete;
+    WorkerPool& operator=(WorkerPool const&) = delete;
+    /**
+     * Queue a job with the given priority
+     * */
+    template<typename R>
+    std::future<R> submit(std::function<R()> job, Priority priority = nullptr)
+    {
+        auto task = std::make_shared< std::packaged_task<R()> >(job);
+        std::future<R> f = task->get_future();
+        push( [task](){ (*task)(); }, priority );
+        return f;
+    }
+    /**
+     * Remove pending jobs submitted with this priority
+     * */
+    void cancel(Priority priority);
+    /**
+     * Get number of threads
+     * */
+    inline size_t numWorkers() const { return workers_.size(); }
+    /**
+     * Get number of jobs waiting for a worker
+     * */
+    size_t numPending();
+
+private:
+    struct Job {
+        std::function<void()> run;
+        Priority priority;
+    };
+    void push(std::function<void()> run, Priority priority);
+    void work();
+
+    std::vector<std::thread> workers_;
+    std::list<Job> jobs_;
+    std::mutex access_;
+    std::condition_variable condition_;
+    bool stop_;
+    static std::atomic<ThreadInit> thread_init_;
+};
+
+#endif // WORKERPOOL_H
@@ -35,6 +35,7 @@
 #define MIXING_MIN_SCALE 0.8f
 #define MIXING_MAX_SCALE 7.0f
 #define MIXING_LIMBO_SCALE 1.3f
+#define MIXING_LIMBO_WAKEUP 1.5f
 #define MIXING_ICON_SCALE 0.15f, 0.15f, 1.f
 #define GEOMETRY_DEFAULT_SCALE 1.4f
 #define GEOMETRY_MIN_SCALE 0.4f
@@ -60,6 +61,7 @@
 #define TRANSITION_MAX_DURATION 10.f
 #define ARROWS_MOVEMENT_FACTOR 4.f
 #define SESSION_THUMBNAIL_HEIGHT 120.f
+#define SOURCE_THUMBNAIL_HEIGHT 240.f
 
 #define IMGUI_TITLE_MAINWINDOW ICON_FA_CIRCLE_NOTCH "  vimix"
 #define IMGUI_TITLE_MEDIAPLAYER ICON_FA_PLAY_CIRCLE "  Player"
@@ -10,6 +10,8 @@
 #include "RenderingManager.h"
 #include "UserInterfaceManager.h"
 #include "Connection.h"
+#include "DecoderThreads.h"
+#include "MediaPlayer.h"
 
 
 #if defined(APPLE)
@@ -96,6 +98,10 @@ int main(int argc, char *argv[])
     gst_debug_set_active(FALSE);
 #endif
 
+    // render thread kept on one core (optional)
+    if (Settings::application.render.render_affinity)
+        DecoderThreads::pinRenderThread();
+
     // draw the scene
     Rendering::manager().pushFrontDrawCallback(drawScene);
 
@@ -134,6 +140,7 @@ int main(int argc, char *argv[])
     /// Settings
     ///
     Settings::Save();
+    MediaPlayer::saveDiscovererCache();
 
     /// ok
     return 0;
@@ -0,0 +1,62 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec4 vertexColor;
+in vec2 vertexUV;
+
+// from General Shader
+uniform vec3 iResolution;           // viewport image resolution (in pixels)
+uniform mat4 iTransform;            // image transformation
+uniform vec4 color;
+
+// YUV Shader
+uniform sampler2D iChannel0;        // luma plane (Y), or packed pixels
+uniform sampler2D iChannel1;        // chroma plane (U), or interleaved (UV)
+uniform sampler2D iChannel2;        // chroma plane (V)
+uniform vec2 coefficients;          // luma coefficients Kr and Kb of color matrix
+uniform bool fullrange;             // [0 255] range instead of [16 235]
+uniform int layout;                 // 0: planar (I420), 1: semi-planar (NV12), 2: packed (YUY2)
+
+void main()
+{
+    float Y, Cb, Cr;
+
+    if (layout == 2) {
+        // two pixels in each texel: Y0 U Y1 V
+        ivec2 size = textureSize(iChannel0, 0);
+        ivec2 p = ivec2(vertexUV * vec2(size.x * 2, size.y));
+        p = clamp(p, ivec2(0), ivec2(size.x * 2 - 1, size.y - 1));
+        vec4 yuyv = texelFetch(iChannel0, ivec2(p.x / 2, p.y), 0);
+        Y  = (p.x % 2 == 0) ? yuyv.r : yuyv.b;
+        Cb = yuyv.g - 0.5;
+        Cr = yuyv.a - 0.5;
+    }
+    else if (layout == 1) {
+        Y  = texture(iChannel0, vertexUV).r;
+        vec2 C = texture(iChannel1, vertexUV).rg - 0.5;
+        Cb = C.x;
+        Cr = C.y;
+    }
+    else {
+        Y  = texture(iChannel0, vertexUV).r;
+        Cb = texture(iChannel1, vertexUV).r - 0.5;
+        Cr = texture(iChannel2, vertexUV).r - 0.5;
+    }
+
+    // scale video range to full range
+    if (!fullrange) {
+        Y  = (Y - 16.0 / 255.0) * (255.0 / 219.0);
+        Cb = Cb * (255.0 / 224.0);
+        Cr = Cr * (255.0 / 224.0);
+    }
+
+    // generic conversion from luma coefficients
+    float Kr = coefficients.x;
+    float Kb = coefficients.y;
+    float R = Y + 2.0 * (1.0 - Kr) * Cr;
+    float B = Y + 2.0 * (1.0 - Kb) * Cb;
+    float G = (Y - Kr * R - Kb * B) / (1.0 - Kr - Kb);
+
+    FragColor = vec4(clamp(vec3(R, G, B), 0.0, 1.0), 1.0);
+}
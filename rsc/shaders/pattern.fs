@@ -0,0 +1,111 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec4 vertexColor;
+in vec2 vertexUV;
+
+// from General Shader
+uniform vec3 iResolution;           // viewport image resolution (in pixels)
+uniform mat4 iTransform;            // image transformation
+uniform vec4 color;
+
+// Pattern Shader
+uniform int pattern;                // index of pattern (see Pattern::pattern_types)
+uniform float iTime;                // time of animation (in seconds)
+
+const float PI = 3.14159265359;
+
+// random value in [0 1] for a pixel and a frame
+float random(vec2 p, float t)
+{
+    return fract(sin(dot(p + t, vec2(12.9898, 78.233))) * 43758.5453);
+}
+
+// SMPTE color bars (100% or 75% intensity)
+vec3 bars(float x, float level)
+{
+    int i = int(floor(x * 7.0));
+    vec3 c = vec3( i < 2 || i == 4 || i == 5 ? 1.0 : 0.0,
+                   i < 4 ? 1.0 : 0.0,
+                   i == 0 || i == 2 || i == 4 || i == 6 ? 1.0 : 0.0 );
+    return c * level;
+}
+
+void main()
+{
+    // uv with origin at top-left, and pixel coordinates
+    vec2 uv = vertexUV;
+    vec2 px = floor(uv * iResolution.xy);
+    // centered coordinates with aspect ratio
+    vec2 p = (uv - 0.5) * vec2(iResolution.x / iResolution.y, 1.0);
+    float r = length(p);
+    float a = atan(p.y, p.x);
+
+    vec3 c = vec3(0.0);
+
+    if (pattern == 1)           // White
+        c = vec3(1.0);
+    else if (pattern == 2)      // Gradient
+        c = vec3(uv.y);
+    else if (pattern == 3)      // Checkers 1x1 px
+        c = vec3( mod(px.x + px.y, 2.0) );
+    else if (pattern == 4)      // Checkers 8x8 px
+        c = vec3( mod(floor(px.x / 8.0) + floor(px.y / 8.0), 2.0) );
+    else if (pattern == 5)      // Circles
+        c = vec3( 0.5 + 0.5 * cos(r * 80.0 * PI) );
+    else if (pattern == 7)      // Pinwheel
+        c = vec3( step(0.0, sin(a * 15.0)) );
+    else if (pattern == 8)      // Spokes
+        c = vec3( smoothstep(0.9, 1.0, cos(a * 15.0)) );
+    else if (pattern == 9)      // Red
+        c = vec3(1.0, 0.0, 0.0);
+    else if (pattern == 10)     // Green
+        c = vec3(0.0, 1.0, 0.0);
+    else if (pattern == 11)     // Blue
+        c = vec3(0.0, 0.0, 1.0);
+    else if (pattern == 12)     // Color bars
+        c = bars(uv.x, 1.0);
+    else if (pattern == 13)     // RGB grid
+        c = vec3( fract(uv.x * 4.0), fract(uv.y * 4.0), (floor(uv.x * 4.0) + 4.0 * floor(uv.y * 4.0)) / 15.0 );
+    else if (pattern == 14) {   // SMPTE test pattern
+        if (uv.y < 0.67)
+            c = bars(uv.x, 0.75);
+        else if (uv.y < 0.75) {
+            // reversed blue bars
+            int i = int(floor(uv.x * 7.0));
+            c = (i % 2 == 0) ? bars(1.0 - (float(i) + 0.5) / 7.0, 0.75) : vec3(0.0);
+        }
+        else {
+            // -I, white, +Q, black and pluge
+            float x = uv.x * 6.0;
+            if (x < 1.0)       c = vec3(0.0, 0.13, 0.3);
+            else if (x < 2.0)  c = vec3(1.0);
+            else if (x < 3.0)  c = vec3(0.2, 0.0, 0.42);
+            else if (x < 4.5)  c = vec3(0.0);
+            else if (x < 5.0)  c = vec3(0.035 * floor((x - 4.5) * 6.0));
+            else               c = vec3(0.0);
+        }
+    }
+    else if (pattern == 15)     // Television snow
+        c = vec3( random(px, iTime) );
+    else if (pattern == 16)     // Blink
+        c = vec3( mod(floor(iTime * 30.0), 2.0) );
+    else if (pattern == 17)     // Fresnel zone plate
+        c = vec3( 0.5 + 0.5 * cos( 200.0 * r * r - iTime * 4.0 ) );
+    else if (pattern == 18) {   // Chroma zone plate
+        float z = 200.0 * r * r - iTime * 4.0;
+        c = vec3( 0.5 + 0.5 * cos(z), 0.5 + 0.5 * cos(z + 2.0 * PI / 3.0), 0.5 + 0.5 * cos(z + 4.0 * PI / 3.0) );
+    }
+    else if (pattern == 19) {   // Bar moving
+        float x = fract(iTime * 0.2);
+        c = vec3( step(abs(uv.x - x), 0.05) );
+    }
+    else if (pattern == 20) {   // Ball bouncing
+        vec2 range = vec2(iResolution.x / iResolution.y, 1.0) * 0.5 - 0.05;
+        vec2 b = range * ( abs(fract(iTime * vec2(0.31, 0.43)) * 2.0 - 1.0) * 2.0 - 1.0 );
+        c = vec3( 1.0 - smoothstep(0.045, 0.05, length(p - b)) );
+    }
+
+    FragColor = vec4(c, 1.0);
+}